@@ -617,7 +617,7 @@ void GafFeatures::addObjectsToScene()
         ss.str("");
         
 		ss << "VRAM: ";
-        ss << m_asset->getTextureManager()->getMemoryConsumptionStat();
+        ss << m_asset->getTextureDataSize();
         ss << " bytes";
         
         m_vramStat->setString(ss.str());
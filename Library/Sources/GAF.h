@@ -9,11 +9,16 @@
 
 #include "GAFMacros.h"
 #include "GAFAsset.h"
+#include "GAFAssetCache.h"
 #include "GAFTextureAtlas.h"
 #include "GAFObject.h"
 #include "GAFAssetTextureManager.h"
+#include "GAFTextureUploadScheduler.h"
+#include "GAFCompressedTexture.h"
 #include "GAFDelegates.h"
 #include "GAFTimeline.h"
+#include "GAFTimelineEvaluator.h"
+#include "GAFAnimationManager.h"
 
 #define GAF_VERSION 5.0
 
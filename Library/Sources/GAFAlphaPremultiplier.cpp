@@ -0,0 +1,72 @@
+#include "GAFPrecompiled.h"
+#include "GAFAlphaPremultiplier.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GAF_PREMULTIPLY_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define GAF_PREMULTIPLY_NEON 1
+#include <arm_neon.h>
+#endif
+
+NS_GAF_BEGIN
+
+void GAFAlphaPremultiplier::premultiply(unsigned char* data, size_t count)
+{
+    size_t i = 0;
+
+#if GAF_PREMULTIPLY_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+
+    // 4 pixels at a time, channels are widened to 16 bits where c * (a + 1) fits
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i* ptr = reinterpret_cast<__m128i*>(data + i * 4);
+        const __m128i pixels = _mm_loadu_si128(ptr);
+
+        __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+        __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+
+        // Alpha of every pixel goes to all its lanes
+        __m128i alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+        lo = _mm_srli_epi16(_mm_mullo_epi16(lo, _mm_add_epi16(alphaLo, one)), 8);
+        hi = _mm_srli_epi16(_mm_mullo_epi16(hi, _mm_add_epi16(alphaHi, one)), 8);
+
+        const __m128i result = _mm_packus_epi16(lo, hi);
+        _mm_storeu_si128(ptr, _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, pixels)));
+    }
+#elif GAF_PREMULTIPLY_NEON
+    // 8 pixels at a time split into channel planes, c * a + c is computed in 16 bits
+    for (; i + 8 <= count; i += 8)
+    {
+        uint8x8x4_t pixels = vld4_u8(data + i * 4);
+
+        for (int c = 0; c < 3; ++c)
+        {
+            pixels.val[c] = vshrn_n_u16(vaddw_u8(vmull_u8(pixels.val[c], pixels.val[3]), pixels.val[c]), 8);
+        }
+
+        vst4_u8(data + i * 4, pixels);
+    }
+#endif
+
+    premultiplyScalar(data + i * 4, count - i);
+}
+
+void GAFAlphaPremultiplier::premultiplyScalar(unsigned char* data, size_t count)
+{
+    for (unsigned char* pixel = data, *end = data + count * 4; pixel != end; pixel += 4)
+    {
+        const unsigned int a = pixel[3] + 1;
+
+        pixel[0] = static_cast<unsigned char>(pixel[0] * a >> 8);
+        pixel[1] = static_cast<unsigned char>(pixel[1] * a >> 8);
+        pixel[2] = static_cast<unsigned char>(pixel[2] * a >> 8);
+    }
+}
+
+NS_GAF_END
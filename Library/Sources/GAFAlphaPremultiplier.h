@@ -0,0 +1,20 @@
+#pragma once
+
+#include "GAFMacros.h"
+
+#include <stddef.h>
+
+NS_GAF_BEGIN
+
+/// Alpha premultiplication of decoded atlas images for cocos2d-x versions that do not premultiply them
+class GAFAlphaPremultiplier
+{
+public:
+    /// Premultiplies RGBA8888 pixels in place. Every color channel becomes c * (a + 1) >> 8 exactly as
+    /// CC_RGB_PREMULTIPLY_ALPHA does. SSE2 or NEON is used where available, bytes are the same as of premultiplyScalar
+    static void premultiply(unsigned char* data, size_t count);
+    /// Reference implementation of premultiply, one pixel at a time
+    static void premultiplyScalar(unsigned char* data, size_t count);
+};
+
+NS_GAF_END
@@ -1,37 +1,59 @@
 #include "GAFPrecompiled.h"
 #include "GAFAnimationFrame.h"
-#include "GAFSubobjectState.h"
 #include "GAFTextureAtlas.h"
 
 NS_GAF_BEGIN
 
-GAFAnimationFrame::GAFAnimationFrame()
+GAFAnimationFrame::GAFAnimationFrame(bool isKeyframe, const uint32_t* states, const uint32_t* stateSlots, uint32_t statesCount)
+: m_subObjectStates(states)
+, m_stateSlots(stateSlots)
+, m_statesCount(statesCount)
+, m_isKeyframe(isKeyframe)
 {
 
 }
 
 GAFAnimationFrame::~GAFAnimationFrame()
 {
-    for (SubobjectStates_t::iterator i = m_subObjectStates.begin(), e = m_subObjectStates.end(); i != e; ++i)
-    {
-        (*i)->release();
-    }
 }
 
-const GAFAnimationFrame::SubobjectStates_t& GAFAnimationFrame::getObjectStates() const
+bool GAFAnimationFrame::isKeyframe() const
+{
+    return m_isKeyframe;
+}
+
+const uint32_t* GAFAnimationFrame::getObjectStates() const
 {
     return m_subObjectStates;
 }
 
+uint32_t GAFAnimationFrame::getObjectStatesCount() const
+{
+    return m_statesCount;
+}
+
+const uint32_t* GAFAnimationFrame::getStateSlots() const
+{
+    return m_stateSlots;
+}
+
 const GAFAnimationFrame::TimelineActions_t & GAFAnimationFrame::getTimelineActions() const
 {
     return m_timelineActions;
 }
 
-void GAFAnimationFrame::pushObjectState(GAFSubobjectState* state)
+void GAFAnimationFrame::applyObjectStates(SubobjectStates_t& states) const
 {
-    m_subObjectStates.push_back(state);
-    state->addRef();
+    if (m_isKeyframe)
+    {
+        states.assign(m_subObjectStates, m_subObjectStates + m_statesCount);
+        return;
+    }
+
+    for (uint32_t i = 0; i < m_statesCount; ++i)
+    {
+        states[m_stateSlots[i]] = m_subObjectStates[i];
+    }
 }
 
 void GAFAnimationFrame::pushTimelineAction(GAFTimelineAction action)
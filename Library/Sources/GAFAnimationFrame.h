@@ -1,26 +1,44 @@
 #pragma once
 #include "GAFTimelineAction.h"
+#include "GAFStateStore.h"
 
 NS_GAF_BEGIN
 
 class GAFTextureAtlas;
-class GAFSubobjectState;
 
+/// Keyframes hold the state of every animation object of the timeline (ordered by object id).
+/// All other frames hold only the states that changed since the previous frame together with
+/// the slots they occupy in the keyframe list, see GAFTimeline::getFrameStates.
+/// States are indices in the GAFStateStore of the timeline
 class GAFAnimationFrame
 {
 public:
-    typedef std::vector<GAFSubobjectState*> SubobjectStates_t;
+    typedef GAFStateStore::StateIndices_t SubobjectStates_t;
     typedef std::vector<GAFTimelineAction> TimelineActions_t;
 private:
-    SubobjectStates_t       m_subObjectStates;
+    const uint32_t*         m_subObjectStates;
+    const uint32_t*         m_stateSlots;
+    uint32_t                m_statesCount;
+    bool                    m_isKeyframe;
     TimelineActions_t       m_timelineActions;
 public:
-    GAFAnimationFrame();
+    /// @param states array of statesCount state indices, stateSlots - their slots (delta frames only).
+    /// Arrays are not copied and must outlive the frame, they are allocated from the asset arena as the frame itself
+    GAFAnimationFrame(bool isKeyframe, const uint32_t* states, const uint32_t* stateSlots, uint32_t statesCount);
     ~GAFAnimationFrame();
-    const SubobjectStates_t& getObjectStates() const;
+
+    bool isKeyframe() const;
+
+    /// All object states for keyframes, changed states only otherwise
+    const uint32_t*          getObjectStates() const;
+    uint32_t                 getObjectStatesCount() const;
+    /// Slots of the changed states, nullptr for keyframes
+    const uint32_t*          getStateSlots() const;
     const TimelineActions_t& getTimelineActions() const;
 
-    void    pushObjectState(GAFSubobjectState*);
+    /// Brings states of the previous frame to the states of this frame
+    void    applyObjectStates(SubobjectStates_t& states) const;
+
     void    pushTimelineAction(GAFTimelineAction action);
 };
 
@@ -0,0 +1,452 @@
+#include "GAFPrecompiled.h"
+#include "GAFAnimationManager.h"
+#include "GAFObject.h"
+
+NS_GAF_BEGIN
+
+static const char* const s_scheduleKey = "GAFAnimationManager";
+
+GAFAnimationManager* GAFAnimationManager::s_instance = nullptr;
+
+GAFAnimationManager::GAFAnimationManager()
+: m_objectsCount(0)
+, m_isScheduled(false)
+, m_isUpdating(false)
+, m_parallelThreshold(GAF_PARALLEL_EVALUATION_THRESHOLD)
+, m_nextEvaluatedObject(0)
+, m_generation(0)
+, m_finishedWorkers(0)
+, m_isStopping(false)
+{
+}
+
+GAFAnimationManager::~GAFAnimationManager()
+{
+    _setScheduled(false);
+    _stopWorkers();
+
+    for (Groups_t::iterator g = m_groups.begin(), e = m_groups.end(); g != e; ++g)
+    {
+        for (Objects_t::iterator i = g->second.objects.begin(), ie = g->second.objects.end(); i != ie; ++i)
+        {
+            if (*i)
+            {
+                (*i)->m_animationsSelectorScheduled = false;
+            }
+        }
+    }
+}
+
+GAFAnimationManager* GAFAnimationManager::getInstance()
+{
+    if (!s_instance)
+    {
+        s_instance = new GAFAnimationManager();
+    }
+    return s_instance;
+}
+
+void GAFAnimationManager::destroyInstance()
+{
+    delete s_instance;
+    s_instance = nullptr;
+}
+
+void GAFAnimationManager::addObject(GAFObject* object, int group /*= 0*/)
+{
+    Group& g = m_groups[group];
+
+    object->m_animationGroup = group;
+    object->m_animationIndex = g.objects.size();
+    g.objects.push_back(object);
+
+    ++m_objectsCount;
+
+    _setScheduled(true);
+}
+
+void GAFAnimationManager::removeObject(GAFObject* object)
+{
+    Groups_t::iterator g = m_groups.find(object->m_animationGroup);
+    if (g == m_groups.end())
+    {
+        return;
+    }
+
+    Objects_t& objects = g->second.objects;
+    const size_t index = object->m_animationIndex;
+
+    if (index >= objects.size() || objects[index] != object)
+    {
+        return;
+    }
+
+    // An evaluated frame is not applied to a removed object
+    object->m_isEvaluated = false;
+
+    if (m_isUpdating)
+    {
+        // The update walks the list by index, it is compacted once the update ends
+        objects[index] = nullptr;
+        ++g->second.removedCount;
+    }
+    else
+    {
+        // Objects after the removed one keep their order
+        objects.erase(objects.begin() + index);
+        for (size_t i = index; i < objects.size(); ++i)
+        {
+            objects[i]->m_animationIndex = i;
+        }
+    }
+
+    --m_objectsCount;
+}
+
+void GAFAnimationManager::pauseGroup(int group)
+{
+    m_groups[group].isPaused = true;
+}
+
+void GAFAnimationManager::resumeGroup(int group)
+{
+    Groups_t::iterator g = m_groups.find(group);
+    if (g != m_groups.end())
+    {
+        g->second.isPaused = false;
+    }
+}
+
+bool GAFAnimationManager::isGroupPaused(int group) const
+{
+    Groups_t::const_iterator g = m_groups.find(group);
+    return g != m_groups.end() && g->second.isPaused;
+}
+
+size_t GAFAnimationManager::getObjectsCount() const
+{
+    return m_objectsCount;
+}
+
+void GAFAnimationManager::setParallelThreshold(size_t objectsCount)
+{
+    m_parallelThreshold = objectsCount;
+
+    if (!m_parallelThreshold)
+    {
+        _stopWorkers();
+    }
+}
+
+size_t GAFAnimationManager::getParallelThreshold() const
+{
+    return m_parallelThreshold;
+}
+
+void GAFAnimationManager::_setScheduled(bool value)
+{
+    if (m_isScheduled == value)
+    {
+        return;
+    }
+
+    cocos2d::Scheduler* scheduler = cocos2d::Director::getInstance()->getScheduler();
+
+    if (value)
+    {
+        scheduler->schedule(std::bind(&GAFAnimationManager::_update, this, std::placeholders::_1), this, 0.f, false, s_scheduleKey);
+    }
+    else
+    {
+        scheduler->unschedule(s_scheduleKey, this);
+    }
+
+    m_isScheduled = value;
+}
+
+uint32_t GAFAnimationManager::_getFramesCount(Group& group, uint32_t fps, float dt)
+{
+    for (Clocks_t::iterator i = group.clocks.begin(), e = group.clocks.end(); i != e; ++i)
+    {
+        if (i->fps == fps)
+        {
+            return i->framesCount;
+        }
+    }
+
+    if (fps == 0)
+    {
+        return 0;
+    }
+
+    // First object of the fps in the group, its clock starts with this update
+    Clock clock = { fps, dt, 0 };
+    const double frameTime = 1.0 / fps;
+    while (clock.timeDelta >= frameTime)
+    {
+        clock.timeDelta -= frameTime;
+        ++clock.framesCount;
+    }
+
+    group.clocks.push_back(clock);
+    return clock.framesCount;
+}
+
+void GAFAnimationManager::_advanceClocks(Group& group, float dt)
+{
+    for (Clocks_t::iterator i = group.clocks.begin(), e = group.clocks.end(); i != e; ++i)
+    {
+        i->timeDelta += dt;
+        i->framesCount = 0;
+
+        const double frameTime = 1.0 / i->fps;
+        while (i->timeDelta >= frameTime)
+        {
+            i->timeDelta -= frameTime;
+            ++i->framesCount;
+        }
+    }
+}
+
+void GAFAnimationManager::_update(float dt)
+{
+    if (m_parallelThreshold && m_objectsCount >= m_parallelThreshold)
+    {
+        _evaluateObjects(dt);
+    }
+
+    m_isUpdating = true;
+
+    for (Groups_t::iterator g = m_groups.begin(); g != m_groups.end(); ++g)
+    {
+        Group& group = g->second;
+
+        const bool isAdvanced = group.isAdvanced;
+        group.isAdvanced = false;
+
+        // Groups paused by delegates since their objects were evaluated still get the evaluated frames applied
+        if (group.isPaused && !isAdvanced)
+        {
+            continue;
+        }
+
+        if (!isAdvanced)
+        {
+            _advanceClocks(group, dt);
+        }
+
+        // Objects started by delegates are advanced from the next update
+        const size_t count = group.objects.size();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            GAFObject* object = group.objects[i];
+
+            if (!object)
+            {
+                continue;
+            }
+
+            // Evaluated objects have been advanced already, the frame is applied even if a delegate has paused them since
+            if (object->m_isEvaluated)
+            {
+                object->_applyEvaluation();
+                continue;
+            }
+
+            // Scheduled selectors of nodes out of the running scene or paused are not called either
+            if (group.isPaused || !object->isRunning() || object->m_isTickPaused)
+            {
+                continue;
+            }
+
+            const uint32_t framesCount = object->m_skipFpsCheck ? 1 : _getFramesCount(group, object->m_fps, dt);
+
+            if (framesCount)
+            {
+                object->processAnimations(framesCount);
+            }
+        }
+    }
+
+    m_isUpdating = false;
+
+    _compact();
+
+    if (!m_objectsCount)
+    {
+        _setScheduled(false);
+    }
+}
+
+void GAFAnimationManager::_evaluateObjects(float dt)
+{
+    m_evaluatedObjects.clear();
+
+    for (Groups_t::iterator g = m_groups.begin(), e = m_groups.end(); g != e; ++g)
+    {
+        Group& group = g->second;
+
+        if (group.isPaused)
+        {
+            continue;
+        }
+
+        _advanceClocks(group, dt);
+        group.isAdvanced = true;
+
+        for (Objects_t::iterator i = group.objects.begin(), ie = group.objects.end(); i != ie; ++i)
+        {
+            GAFObject* object = *i;
+
+            if (!object->isRunning() || object->m_isTickPaused)
+            {
+                continue;
+            }
+
+            // Only top-level objects are evaluable, two threads never step the same nested timeline
+            const uint32_t framesCount = object->m_skipFpsCheck ? 1 : _getFramesCount(group, object->m_fps, dt);
+            if (framesCount && object->_isEvaluable(framesCount))
+            {
+                m_evaluatedObjects.push_back(std::make_pair(object, framesCount));
+            }
+        }
+    }
+
+    if (m_evaluatedObjects.size() < m_parallelThreshold)
+    {
+        // Not worth waking the workers, the objects are played on the main thread
+        m_evaluatedObjects.clear();
+        return;
+    }
+
+    for (Evaluated_t::iterator i = m_evaluatedObjects.begin(), e = m_evaluatedObjects.end(); i != e; ++i)
+    {
+        i->first->m_isEvaluated = true;
+    }
+
+    if (m_workers.empty())
+    {
+        _startWorkers();
+    }
+
+    m_nextEvaluatedObject = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_workersMutex);
+        m_finishedWorkers = 0;
+        ++m_generation;
+    }
+    m_workersCondition.notify_all();
+
+    _evaluateNextObjects();
+
+    std::unique_lock<std::mutex> lock(m_workersMutex);
+    m_finishedCondition.wait(lock, [this]() { return m_finishedWorkers == m_workers.size(); });
+}
+
+void GAFAnimationManager::_evaluateNextObjects()
+{
+    // Objects differ in size a lot, every thread takes the next one when it is done with its current one
+    for (size_t i = m_nextEvaluatedObject++; i < m_evaluatedObjects.size(); i = m_nextEvaluatedObject++)
+    {
+        m_evaluatedObjects[i].first->_evaluate(m_evaluatedObjects[i].second);
+    }
+}
+
+void GAFAnimationManager::_startWorkers()
+{
+    const unsigned int threadsCount = std::thread::hardware_concurrency();
+
+    m_isStopping = false;
+
+    // The main thread is one of them
+    for (unsigned int i = 1; i < threadsCount; ++i)
+    {
+        m_workers.push_back(std::thread(&GAFAnimationManager::_workerLoop, this, m_generation));
+    }
+}
+
+void GAFAnimationManager::_stopWorkers()
+{
+    if (m_workers.empty())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_workersMutex);
+        m_isStopping = true;
+    }
+    m_workersCondition.notify_all();
+
+    for (std::thread& t : m_workers)
+    {
+        t.join();
+    }
+
+    m_workers.clear();
+}
+
+void GAFAnimationManager::_workerLoop(uint32_t generation)
+{
+    std::unique_lock<std::mutex> lock(m_workersMutex);
+
+    for (;;)
+    {
+        m_workersCondition.wait(lock, [this, generation]() { return m_isStopping || m_generation != generation; });
+
+        if (m_isStopping)
+        {
+            return;
+        }
+
+        generation = m_generation;
+
+        lock.unlock();
+        _evaluateNextObjects();
+        lock.lock();
+
+        if (++m_finishedWorkers == m_workers.size())
+        {
+            m_finishedCondition.notify_one();
+        }
+    }
+}
+
+void GAFAnimationManager::_compact()
+{
+    for (Groups_t::iterator g = m_groups.begin(); g != m_groups.end();)
+    {
+        Group& group = g->second;
+
+        if (group.removedCount)
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < group.objects.size(); ++i)
+            {
+                GAFObject* object = group.objects[i];
+                if (object)
+                {
+                    object->m_animationIndex = count;
+                    group.objects[count++] = object;
+                }
+            }
+
+            group.objects.resize(count);
+            group.removedCount = 0;
+        }
+
+        // Paused groups are kept for the objects added later
+        if (group.objects.empty() && !group.isPaused)
+        {
+            g = m_groups.erase(g);
+        }
+        else
+        {
+            ++g;
+        }
+    }
+}
+
+NS_GAF_END
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "GAFMacros.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+NS_GAF_BEGIN
+
+class GAFObject;
+
+/// Advances all playing GAFObjects in one scheduler update instead of a scheduled selector per object.
+/// Objects are kept in groups updated in the ascending order of their priorities, objects of one group
+/// in the order they were started. Every group has a clock per fps its objects play at, so objects of
+/// the same group and fps step on the same frames. A paused group keeps its objects and its clocks stop.
+/// When many objects step in an update, top-level ones are evaluated on worker threads first: frames are advanced,
+/// actions performed and states composed by GAFTimelineEvaluator without touching nodes. The evaluated frames are
+/// applied to nodes and their events are dispatched on the main thread afterwards, in the order objects are updated.
+/// Objects with delegates or stencils made of timelines are always played on the main thread
+/// @note must be used on the main thread only
+class GAFAnimationManager
+{
+private:
+    struct Clock
+    {
+        uint32_t            fps;
+        double              timeDelta;
+        uint32_t            framesCount; // Frames to play in the current update
+    };
+
+    typedef std::vector<Clock> Clocks_t;
+    typedef std::vector<GAFObject*> Objects_t;
+
+    struct Group
+    {
+        Objects_t           objects;        // Removed during the update ones are nullptr till it ends
+        Clocks_t            clocks;
+        size_t              removedCount;
+        bool                isPaused;
+        bool                isAdvanced;     // Clocks of the update have been advanced before its objects were evaluated
+
+        Group() : removedCount(0), isPaused(false), isAdvanced(false) {}
+    };
+
+    typedef std::map<int, Group> Groups_t;
+
+    Groups_t            m_groups;
+    size_t              m_objectsCount;
+    bool                m_isScheduled;
+    bool                m_isUpdating;
+
+    typedef std::vector<std::pair<GAFObject*, uint32_t> > Evaluated_t;
+
+    Evaluated_t         m_evaluatedObjects; // With their frames count, evaluated in the current update
+    size_t              m_parallelThreshold;
+
+    std::vector<std::thread> m_workers;
+    std::mutex          m_workersMutex;
+    std::condition_variable m_workersCondition;
+    std::condition_variable m_finishedCondition;
+    std::atomic<size_t> m_nextEvaluatedObject;
+    uint32_t            m_generation;       // Of the objects being evaluated, workers wait for a new one
+    size_t              m_finishedWorkers;
+    bool                m_isStopping;
+
+    static GAFAnimationManager* s_instance;
+
+    GAFAnimationManager();
+
+    void                _update(float dt);
+    void                _setScheduled(bool value);
+    void                _advanceClocks(Group& group, float dt);
+    uint32_t            _getFramesCount(Group& group, uint32_t fps, float dt);
+    void                _compact();
+
+    /// Advances the clocks and evaluates the objects that can be on the workers
+    void                _evaluateObjects(float dt);
+    void                _evaluateNextObjects();
+    void                _startWorkers();
+    void                _stopWorkers();
+    void                _workerLoop(uint32_t generation);
+
+public:
+    ~GAFAnimationManager();
+
+    static GAFAnimationManager* getInstance();
+    /// Objects stop being advanced, start them again to use a new instance
+    static void         destroyInstance();
+
+    /// The object is not retained, GAFObject removes itself when it stops or is destroyed
+    void                addObject(GAFObject* object, int group = 0);
+    void                removeObject(GAFObject* object);
+
+    void                pauseGroup(int group);
+    void                resumeGroup(int group);
+    bool                isGroupPaused(int group) const;
+
+    /// Objects of all groups
+    size_t              getObjectsCount() const;
+
+    /// Number of objects stepping in one update from which top-level ones are evaluated on worker threads,
+    /// 0 turns the workers off. Default is GAF_PARALLEL_EVALUATION_THRESHOLD
+    void                setParallelThreshold(size_t objectsCount);
+    size_t              getParallelThreshold() const;
+};
+
+NS_GAF_END
\ No newline at end of file
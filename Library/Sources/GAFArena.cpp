@@ -0,0 +1,165 @@
+#include "GAFPrecompiled.h"
+#include "GAFArena.h"
+
+NS_GAF_BEGIN
+
+static inline size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+const size_t GAFArena::s_blockHeaderSize = alignUp(sizeof(GAFArena::Block), alignof(std::max_align_t));
+
+GAFArena::GAFArena(size_t blockSize /*= GAF_ARENA_BLOCK_SIZE*/)
+: m_blocks(nullptr)
+, m_largeBlocks(nullptr)
+, m_destructors(nullptr)
+, m_blockSize(blockSize)
+, m_allocatedSize(0)
+{
+}
+
+GAFArena::~GAFArena()
+{
+    for (Destructor* d = m_destructors; d; d = d->next)
+    {
+        d->destroy(d->object);
+    }
+
+    _freeBlocks(m_blocks, nullptr);
+    _freeBlocks(m_largeBlocks, nullptr);
+}
+
+void GAFArena::_freeBlocks(Block* first, Block* last)
+{
+    for (Block* b = first; b != last; )
+    {
+        Block* next = b->next;
+        free(b);
+        b = next;
+    }
+}
+
+void* GAFArena::allocate(size_t size, size_t alignment)
+{
+    if (m_blocks)
+    {
+        const size_t offset = alignUp(m_blocks->used, alignment);
+        if (offset + size <= m_blocks->size)
+        {
+            m_blocks->used = offset + size;
+            return reinterpret_cast<unsigned char*>(m_blocks) + s_blockHeaderSize + offset;
+        }
+    }
+
+    return _allocateInNewBlock(size, alignment);
+}
+
+void* GAFArena::_allocateInNewBlock(size_t size, size_t alignment)
+{
+    CCASSERT(alignment <= alignof(std::max_align_t), "Unsupported alignment");
+
+    // Large allocations get a block of their own, the current block stays in use
+    const bool dedicated = size > m_blockSize / 4;
+    const size_t dataSize = dedicated ? size : m_blockSize;
+
+    Block* b = static_cast<Block*>(malloc(s_blockHeaderSize + dataSize));
+    if (!b)
+    {
+        CCLOGERROR("GAFArena: cannot allocate %lu bytes", static_cast<unsigned long>(s_blockHeaderSize + dataSize));
+        return nullptr;
+    }
+
+    b->size = dataSize;
+    b->used = size;
+    m_allocatedSize += s_blockHeaderSize + dataSize;
+
+    Block*& head = dedicated ? m_largeBlocks : m_blocks;
+    b->next = head;
+    head = b;
+
+    return reinterpret_cast<unsigned char*>(b) + s_blockHeaderSize;
+}
+
+void GAFArena::merge(GAFArena& other)
+{
+    if (other.m_blocks)
+    {
+        // Keep own current block first so it is filled up
+        Block* last = other.m_blocks;
+        while (last->next)
+        {
+            last = last->next;
+        }
+
+        if (m_blocks)
+        {
+            last->next = m_blocks->next;
+            m_blocks->next = other.m_blocks;
+        }
+        else
+        {
+            m_blocks = other.m_blocks;
+        }
+    }
+
+    if (other.m_largeBlocks)
+    {
+        Block* last = other.m_largeBlocks;
+        while (last->next)
+        {
+            last = last->next;
+        }
+
+        last->next = m_largeBlocks;
+        m_largeBlocks = other.m_largeBlocks;
+    }
+
+    if (other.m_destructors)
+    {
+        Destructor* last = other.m_destructors;
+        while (last->next)
+        {
+            last = last->next;
+        }
+
+        last->next = m_destructors;
+        m_destructors = other.m_destructors;
+    }
+
+    m_allocatedSize += other.m_allocatedSize;
+
+    other.m_blocks = nullptr;
+    other.m_largeBlocks = nullptr;
+    other.m_destructors = nullptr;
+    other.m_allocatedSize = 0;
+}
+
+GAFArena::Marker GAFArena::getMarker() const
+{
+    Marker marker = { m_blocks, m_blocks ? m_blocks->used : 0, m_largeBlocks, m_destructors, m_allocatedSize };
+    return marker;
+}
+
+void GAFArena::rewind(const Marker& marker)
+{
+    for (Destructor* d = m_destructors; d != marker.destructors; d = d->next)
+    {
+        d->destroy(d->object);
+    }
+    m_destructors = marker.destructors;
+
+    _freeBlocks(m_blocks, marker.block);
+    _freeBlocks(m_largeBlocks, marker.largeBlock);
+
+    m_blocks = marker.block;
+    m_largeBlocks = marker.largeBlock;
+    m_allocatedSize = marker.allocatedSize;
+
+    if (m_blocks)
+    {
+        m_blocks->used = marker.used;
+    }
+}
+
+NS_GAF_END
\ No newline at end of file
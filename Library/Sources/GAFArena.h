@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+NS_GAF_BEGIN
+
+/// Bump allocator for objects that live exactly as long as the asset they are loaded for.
+/// Memory is released at once when the arena is destroyed. Destructors of the objects made by create()
+/// are called then in reverse order of creation.
+/// @note not thread-safe, concurrent loaders use an arena each and merge them afterwards
+class GAFArena
+{
+private:
+    struct Block
+    {
+        Block*  next;
+        size_t  size;
+        size_t  used;
+    };
+
+    struct Destructor
+    {
+        Destructor* next;
+        void        (*destroy)(void*);
+        void*       object;
+    };
+
+    static const size_t s_blockHeaderSize; // Block header is followed by its data
+
+    Block*              m_blocks;       // Current block is the first one
+    Block*              m_largeBlocks;  // Allocations that do not fit a regular block
+    Destructor*         m_destructors;
+    size_t              m_blockSize;
+    size_t              m_allocatedSize;
+
+    GAFArena(const GAFArena&) = delete;
+    GAFArena& operator=(const GAFArena&) = delete;
+
+    void*               _allocateInNewBlock(size_t size, size_t alignment);
+
+    template <typename T>
+    static void         _destroy(void* object) { static_cast<T*>(object)->~T(); }
+
+    static void         _freeBlocks(Block* first, Block* last);
+
+public:
+    /// Arena state to roll back to, see rewind
+    struct Marker
+    {
+        Block*          block;
+        size_t          used;
+        Block*          largeBlock;
+        Destructor*     destructors;
+        size_t          allocatedSize;
+    };
+
+    explicit GAFArena(size_t blockSize = GAF_ARENA_BLOCK_SIZE);
+    ~GAFArena();
+
+    void*               allocate(size_t size, size_t alignment);
+
+    /// Constructs an object in the arena. The object must not be deleted
+    template <typename T, typename... Args>
+    T*                  create(Args&&... args)
+    {
+        void* mem = allocate(sizeof(T), alignof(T));
+        T* object = new (mem) T(std::forward<Args>(args)...);
+
+        if (!std::is_trivially_destructible<T>::value)
+        {
+            Destructor* d = static_cast<Destructor*>(allocate(sizeof(Destructor), alignof(Destructor)));
+            d->next = m_destructors;
+            d->destroy = &GAFArena::_destroy<T>;
+            d->object = object;
+            m_destructors = d;
+        }
+
+        return object;
+    }
+
+    /// Uninitialized storage for count trivial values
+    template <typename T>
+    T*                  allocateArray(size_t count)
+    {
+        static_assert(std::is_trivial<T>::value, "Only trivial types are allowed");
+        return count ? static_cast<T*>(allocate(sizeof(T) * count, alignof(T))) : nullptr;
+    }
+
+    /// Takes over memory and objects of the other arena, which is left empty
+    void                merge(GAFArena& other);
+
+    Marker              getMarker() const;
+    /// Destroys everything created after the marker was taken and reuses its memory
+    void                rewind(const Marker& marker);
+
+    /// Bytes reserved from the system
+    size_t              getAllocatedSize() const { return m_allocatedSize; }
+};
+
+NS_GAF_END
\ No newline at end of file
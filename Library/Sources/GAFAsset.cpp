@@ -5,15 +5,45 @@
 #include "GAFTextData.h"
 #include "GAFObject.h"
 #include "GAFAssetTextureManager.h"
+#include "GAFTextureUploadScheduler.h"
+#include "GAFCompressedTexture.h"
 #include "GAFShaderManager.h"
 #include "GAFTimelineAction.h"
 
 #include "GAFLoader.h"
+#include "GAFBakedAsset.h"
 
 #include "json/document.h"
 
+#include "../external/xxhash/xxhash.h"
+
+#include <thread>
+
 NS_GAF_BEGIN
 
+static std::string s_bakedCacheDirectory;
+
+GAFAssetLoadTask::GAFAssetLoadTask()
+: m_cancelled(false)
+, m_progress(0.f)
+{
+}
+
+void GAFAssetLoadTask::cancel()
+{
+    m_cancelled = true;
+}
+
+bool GAFAssetLoadTask::isCancelled() const
+{
+    return m_cancelled;
+}
+
+float GAFAssetLoadTask::getProgress() const
+{
+    return m_progress;
+}
+
 //static float  _desiredCsf = 1.f;
 
 float GAFAsset::desiredAtlasScale()
@@ -61,7 +91,9 @@ GAFObject* GAFAsset::createObjectAndRun(bool looped)
 }
 
 GAFAsset::GAFAsset() 
-: m_textureLoadDelegate(nullptr)
+: m_currentTextureAtlas(nullptr)
+, m_textureLoadDelegate(nullptr)
+, m_textureManager(nullptr)
 , m_soundDelegate(nullptr)
 , m_sceneFps(60)
 , m_sceneWidth(0)
@@ -69,6 +101,7 @@ GAFAsset::GAFAsset()
 , m_rootTimeline(nullptr)
 , m_desiredAtlasScale(1.0f)
 , m_gafFileName("")
+, m_bakedAsset(nullptr)
 , m_state(State::Normal)
 {
 }
@@ -79,10 +112,9 @@ GAFAsset::~GAFAsset()
     GAF_RELEASE_MAP(SoundInfos_t, m_soundInfos);
     GAF_RELEASE_ARRAY(TextureAtlases_t, m_textureAtlases);
     //CC_SAFE_RELEASE(m_rootTimeline);
-    if (m_state == State::Normal)
-    {
-        m_textureManager->release();
-    }
+    CC_SAFE_RELEASE(m_textureManager);
+    GAF_SAFE_RELEASE_MAP(LodTextureManagers_t, m_lodTextureManagers);
+    delete m_bakedAsset;
 }
 
 bool GAFAsset::isAssetVersionPlayable(const char * version)
@@ -108,6 +140,117 @@ GAFAsset* GAFAsset::create(const std::string& gafFilePath)
     return create(gafFilePath, nullptr);
 }
 
+GAFAsset* GAFAsset::createWithRootTimelines(const std::string& gafFilePath, const std::vector<std::string>& linkageNames, GAFTextureLoadDelegate_t delegate /*= nullptr*/)
+{
+    GAFLoader loader;
+    loader.setRootTimelines(linkageNames);
+
+    return create(gafFilePath, delegate, &loader);
+}
+
+GAFAssetLoadTask* GAFAsset::createAsync(const std::string& gafFilePath, GAFAssetLoadedDelegate_t callback, GAFTextureLoadDelegate_t delegate /*= nullptr*/, GAFAssetLoadProgressDelegate_t progress /*= nullptr*/)
+{
+    // Part of the progress that is taken by parsing, the rest is image decoding
+    static const float ParsingProgress = 0.2f;
+
+    GAFAssetLoadTask* task = new GAFAssetLoadTask();
+    task->autorelease();
+    task->retain(); // Released on the main thread when the worker is done
+
+    GAFAsset* asset = new GAFAsset();
+    asset->m_gafFileName = gafFilePath;
+    asset->m_textureLoadDelegate = delegate;
+
+    const std::string fullfilePath = cocos2d::FileUtils::getInstance()->fullPathForFilename(gafFilePath);
+    cocos2d::Scheduler* scheduler = cocos2d::Director::getInstance()->getScheduler();
+
+    auto reportProgress = [task, scheduler, progress](float value)
+    {
+        task->m_progress = value;
+
+        if (progress)
+        {
+            scheduler->performFunctionInCocosThread([task, progress, value]()
+            {
+                if (!task->isCancelled())
+                {
+                    progress(value);
+                }
+            });
+        }
+    };
+
+    // Compressed variants of images are looked for on the worker, but GL can be asked only here
+    GAFCompressedTexture::getSupportedFormats();
+
+    std::thread worker([=]()
+    {
+        // Ref counters are not thread safe. Neither the asset nor the task may be retained or released here
+        bool isLoaded = !task->isCancelled() && asset->_loadGAFFile(fullfilePath, nullptr);
+
+        if (isLoaded && !task->isCancelled())
+        {
+            reportProgress(ParsingProgress);
+
+            // Images are decoded here, the main thread only uploads them
+            asset->m_textureManager = new GAFAssetTextureManager();
+            asset->loadTextures(fullfilePath, delegate, nullptr, [task, reportProgress](size_t loaded, size_t total)
+            {
+                reportProgress(ParsingProgress + (1.f - ParsingProgress) * loaded / total);
+                return !task->isCancelled();
+            });
+        }
+
+        scheduler->performFunctionInCocosThread([=]()
+        {
+            if (task->isCancelled())
+            {
+                asset->release();
+            }
+            else if (!isLoaded)
+            {
+                asset->release();
+
+                if (callback)
+                {
+                    callback(nullptr);
+                }
+            }
+            else
+            {
+                GAFShaderManager::Initialize();
+
+                // The asset is handed over once all its textures are made
+                GAFTextureUploadScheduler::getInstance()->scheduleUpload(asset->m_textureManager, [task, asset, callback]()
+                {
+                    if (task->isCancelled())
+                    {
+                        asset->release();
+                    }
+                    else
+                    {
+                        asset->autorelease();
+
+                        if (callback)
+                        {
+                            callback(asset);
+                        }
+                    }
+
+                    task->release();
+                });
+                return;
+            }
+
+            task->release();
+        });
+    });
+
+    worker.detach();
+
+    return task;
+}
+
 GAFAsset* GAFAsset::createWithBundle(const std::string& zipfilePath, const std::string& entryFile, GAFTextureLoadDelegate_t delegate, GAFLoader* customLoader /*= nullptr*/)
 {
     GAFAsset * ret = new GAFAsset();
@@ -125,11 +268,42 @@ GAFAsset* GAFAsset::createWithBundle(const std::string& zipfilePath, const std::
     return createWithBundle(zipfilePath, entryFile, nullptr);
 }
 
+void GAFAsset::setBakedCacheDirectory(const std::string& directory)
+{
+    s_bakedCacheDirectory = directory;
+
+    if (!s_bakedCacheDirectory.empty() && s_bakedCacheDirectory.back() != '/' && s_bakedCacheDirectory.back() != '\\')
+    {
+        s_bakedCacheDirectory.push_back('/');
+    }
+}
+
+const std::string& GAFAsset::getBakedCacheDirectory()
+{
+    return s_bakedCacheDirectory;
+}
+
+std::string GAFAsset::_getBakedCachePath() const
+{
+    if (s_bakedCacheDirectory.empty() || m_state != State::Normal)
+    {
+        return std::string();
+    }
+
+    char name[16];
+    snprintf(name, sizeof(name), "%08x.gafb", XXH32(m_gafFileName.data(), m_gafFileName.size(), 0));
+
+    return s_bakedCacheDirectory + name;
+}
+
 void GAFAsset::getResourceReferences(const std::string& gafFilePath, std::vector<GAFResourcesInfo*> &dest)
 {
+    GAFLoader loader;
+    loader.setScanResourcesOnly(true);
+
     GAFAsset * asset = new GAFAsset();
     asset->m_state = State::DryRun;
-    if (asset && asset->initWithGAFFile(gafFilePath, nullptr))
+    if (asset && asset->initWithGAFFile(gafFilePath, nullptr, &loader))
     {
         asset->parseReferences(dest);
     }
@@ -139,9 +313,12 @@ void GAFAsset::getResourceReferences(const std::string& gafFilePath, std::vector
 
 void GAFAsset::getResourceReferencesFromBundle(const std::string& zipfilePath, const std::string& entryFile, std::vector<GAFResourcesInfo*>& dest)
 {
+    GAFLoader loader;
+    loader.setScanResourcesOnly(true);
+
     GAFAsset * asset = new GAFAsset();
     asset->m_state = State::DryRun;
-    if (asset && asset->initWithGAFBundle(zipfilePath, entryFile, nullptr))
+    if (asset && asset->initWithGAFBundle(zipfilePath, entryFile, nullptr, &loader))
     {
         asset->parseReferences(dest);
     }
@@ -165,7 +342,7 @@ bool GAFAsset::initWithGAFBundle(const std::string& zipFilePath, const std::stri
     {
         if (customLoader)
         {
-            customLoader->loadData(gafData, sz, this);
+            isLoaded = customLoader->loadData(gafData, sz, this);
         }
         else
         {
@@ -177,6 +354,7 @@ bool GAFAsset::initWithGAFBundle(const std::string& zipFilePath, const std::stri
     if (isLoaded && m_state == State::Normal)
     {
         m_textureManager = new GAFAssetTextureManager();
+        m_textureManager->setBundlePath(fullfilePath);
         GAFShaderManager::Initialize();
         loadTextures(entryFile, delegate, &bundle);
     }
@@ -189,15 +367,29 @@ bool GAFAsset::initWithGAFFile(const std::string& filePath, GAFTextureLoadDelega
     m_gafFileName = filePath;
     std::string fullfilePath = cocos2d::FileUtils::getInstance()->fullPathForFilename(filePath);
 
+    bool isLoaded = _loadGAFFile(fullfilePath, customLoader);
+
+    if (isLoaded && m_state == State::Normal)
+    {
+        m_textureManager = new GAFAssetTextureManager();
+        GAFShaderManager::Initialize();
+        loadTextures(fullfilePath, delegate);
+    }
+
+    return isLoaded;
+}
+
+bool GAFAsset::_loadGAFFile(const std::string& fullFilePath, GAFLoader* customLoader)
+{
     bool isLoaded = false;
     if (customLoader)
     {
-        isLoaded = customLoader->loadFile(fullfilePath, this);
+        isLoaded = customLoader->loadFile(fullFilePath, this);
     }
     else
     {
         GAFLoader* loader = new GAFLoader();
-        isLoaded = loader->loadFile(fullfilePath, this);
+        isLoaded = loader->loadFile(fullFilePath, this);
         delete loader;
     }
 
@@ -205,12 +397,6 @@ bool GAFAsset::initWithGAFFile(const std::string& filePath, GAFTextureLoadDelega
     {
         return false;
     }
-    if (isLoaded && m_state == State::Normal)
-    {
-        m_textureManager = new GAFAssetTextureManager();
-        GAFShaderManager::Initialize();
-        loadTextures(fullfilePath, delegate);
-    }
 
     return isLoaded;
 }
@@ -286,7 +472,7 @@ void GAFAsset::parseReferences(std::vector<GAFResourcesInfo*>& dest)
     }
 }
 
-void GAFAsset::loadTextures(const std::string& filePath, GAFTextureLoadDelegate_t delegate, cocos2d::ZipFile* bundle /*= nullptr*/)
+void GAFAsset::loadTextures(const std::string& filePath, GAFTextureLoadDelegate_t delegate, cocos2d::ZipFile* bundle /*= nullptr*/, GAFImageLoadedDelegate_t imageLoaded /*= nullptr*/)
 {
     for (Timelines_t::iterator i = m_timelines.begin(), e = m_timelines.end(); i != e; i++)
     {
@@ -305,7 +491,8 @@ void GAFAsset::loadTextures(const std::string& filePath, GAFTextureLoadDelegate_
     }
 
     m_textureLoadDelegate = delegate;
-    m_textureManager->loadImages(filePath, m_textureLoadDelegate, bundle);
+    m_texturesPath = bundle ? std::string() : filePath;
+    m_textureManager->loadImages(filePath, m_textureLoadDelegate, bundle, imageLoaded);
 }
 
 void GAFAsset::loadImages(float desiredAtlasScale)
@@ -519,6 +706,97 @@ GAFAssetTextureManager* GAFAsset::getTextureManager()
     return m_textureManager;
 }
 
+GAFAssetTextureManager* GAFAsset::getTextureManager(GAFTimeline* timeline, GAFTextureAtlas* atlas)
+{
+    if (atlas == timeline->getTextureAtlas())
+    {
+        return m_textureManager;
+    }
+
+    if (m_texturesPath.empty())
+    {
+        return nullptr;
+    }
+
+    const float scale = atlas->getScale();
+
+    LodTextureManagers_t::const_iterator it = m_lodTextureManagers.find(scale);
+    if (it != m_lodTextureManagers.end())
+    {
+        return it->second;
+    }
+
+    // Pages of all atlases of the scale share ids, like the loaded ones do
+    GAFAssetTextureManager* manager = new GAFAssetTextureManager();
+    // Objects switch scales while they are shown, only the pages they draw are decoded
+    manager->setLazyDecoding(true);
+    for (Timelines_t::const_iterator i = m_timelines.begin(), e = m_timelines.end(); i != e; ++i)
+    {
+        const TextureAtlases_t& atlases = i->second->getTextureAtlases();
+        for (TextureAtlases_t::const_iterator a = atlases.begin(), ae = atlases.end(); a != ae; ++a)
+        {
+            if ((*a)->getScale() == scale)
+            {
+                manager->appendInfoFromTextureAtlas(*a);
+            }
+        }
+    }
+
+    manager->loadImages(m_texturesPath, m_textureLoadDelegate);
+    m_lodTextureManagers[scale] = manager;
+
+    return manager;
+}
+
+void GAFAsset::scheduleTexturesUpload(GAFAssetLoadedDelegate_t callback)
+{
+    if (!m_textureManager)
+    {
+        if (callback)
+        {
+            callback(this);
+        }
+        return;
+    }
+
+    retain(); // Released once textures are ready
+
+    GAFTextureUploadScheduler::getInstance()->scheduleUpload(m_textureManager, [this, callback]()
+    {
+        if (callback)
+        {
+            callback(this);
+        }
+
+        release();
+    });
+}
+
+void GAFAsset::releaseUnusedTextures()
+{
+    if (m_textureManager)
+    {
+        m_textureManager->releaseUnusedTextures();
+    }
+
+    for (LodTextureManagers_t::const_iterator i = m_lodTextureManagers.begin(), e = m_lodTextureManagers.end(); i != e; ++i)
+    {
+        i->second->releaseUnusedTextures();
+    }
+}
+
+size_t GAFAsset::getTextureDataSize() const
+{
+    size_t size = m_textureManager ? m_textureManager->getMemoryConsumptionStat() : 0;
+
+    for (LodTextureManagers_t::const_iterator i = m_lodTextureManagers.begin(), e = m_lodTextureManagers.end(); i != e; ++i)
+    {
+        size += i->second->getMemoryConsumptionStat();
+    }
+
+    return size;
+}
+
 GAFTextureAtlas* GAFAsset::getTextureAtlas()
 {
     return m_currentTextureAtlas;
@@ -534,6 +812,42 @@ const Timelines_t& GAFAsset::getTimelines() const
     return m_timelines;
 }
 
+GAFArena& GAFAsset::getArena()
+{
+    return m_arena;
+}
+
+GAFFilterPool& GAFAsset::getFilterPool()
+{
+    return m_filterPool;
+}
+
+size_t GAFAsset::getParsedDataSize() const
+{
+    size_t size = m_arena.getAllocatedSize();
+
+    for (Timelines_t::const_iterator i = m_timelines.begin(), e = m_timelines.end(); i != e; ++i)
+    {
+        size += i->second->getStates().getMemorySize();
+    }
+
+    return size;
+}
+
+GAFParsedDataStats GAFAsset::getParsedDataStats() const
+{
+    GAFParsedDataStats stats = { 0, 0, m_filterPool.getFiltersCount(), m_filterPool.getInternedCount() };
+
+    for (Timelines_t::const_iterator i = m_timelines.begin(), e = m_timelines.end(); i != e; ++i)
+    {
+        const GAFStateStore& states = i->second->getStates();
+        stats.statesCount += states.size();
+        stats.internedStatesCount += states.getInternedCount();
+    }
+
+    return stats;
+}
+
 const GAFHeader& GAFAsset::getHeader() const
 {
     return m_header;
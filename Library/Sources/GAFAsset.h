@@ -5,9 +5,13 @@
 #include "GAFHeader.h"
 #include "GAFTimeline.h"
 #include "GAFTextureAtlas.h"
+#include "GAFArena.h"
+#include "GAFFilterPool.h"
 
 #include "GAFDelegates.h"
 
+#include <atomic>
+
 NS_GAF_BEGIN
 
 class GAFTextureAtlas;
@@ -16,10 +20,39 @@ class GAFAssetTextureManager;
 class GAFTimelineAction;
 
 class GAFLoader;
+class GAFBakedAsset;
+
+/// Handle of the asset being loaded by GAFAsset::createAsync
+class GAFAssetLoadTask : public cocos2d::Ref
+{
+    friend class GAFAsset;
+private:
+    std::atomic<bool>       m_cancelled;
+    std::atomic<float>      m_progress;
+
+    GAFAssetLoadTask();
+public:
+    /// Stops loading as soon as possible. Loaded data is dropped and the completion delegate is not called
+    void                    cancel();
+    bool                    isCancelled() const;
+
+    /// Loading progress from 0.0f to 1.0f
+    float                   getProgress() const;
+};
+
+/// Numbers of object states and filters parsed with an asset, see GAFAsset::getParsedDataStats
+struct GAFParsedDataStats
+{
+    size_t                  statesCount;            // Stored states of all timelines
+    size_t                  internedStatesCount;    // Loaded states replaced with identical stored ones
+    size_t                  filtersCount;           // Distinct filters
+    size_t                  internedFiltersCount;   // Loaded filters replaced with identical ones
+};
 
 class GAFAsset : public cocos2d::Ref
 {
     friend class GAFObject;
+    friend class GAFLoader;
 private:
     GAFHeader               m_header;
 	Timelines_t				m_timelines;
@@ -31,11 +64,16 @@ private:
     void setRootTimeline(GAFTimeline* tl);
 
     void parseReferences(std::vector<GAFResourcesInfo*> &dest);
-    void loadTextures(const std::string& filePath, GAFTextureLoadDelegate_t delegate, cocos2d::ZipFile* bundle = nullptr);
+    bool _loadGAFFile(const std::string& fullFilePath, GAFLoader* customLoader);
+    void loadTextures(const std::string& filePath, GAFTextureLoadDelegate_t delegate, cocos2d::ZipFile* bundle = nullptr, GAFImageLoadedDelegate_t imageLoaded = nullptr);
     void _chooseTextureAtlas(float desiredAtlasScale);
     GAFTextureLoadDelegate_t m_textureLoadDelegate;
 	GAFAssetTextureManager*	m_textureManager;
 
+    typedef std::map<float, GAFAssetTextureManager*> LodTextureManagers_t;
+    LodTextureManagers_t    m_lodTextureManagers; // Atlases of other scales, made when objects ask for them
+    std::string             m_texturesPath; // Images of atlases are relative to it, empty for bundles
+
     GAFSoundDelegate_t m_soundDelegate;
 
     unsigned int            m_sceneFps;
@@ -47,6 +85,10 @@ private:
 
     std::string             m_gafFileName;
 
+    GAFArena                m_arena; // Frames and filters of all timelines, released with the asset
+    GAFFilterPool           m_filterPool; // Filters of all timelines with the same parameters are one object
+    GAFBakedAsset*          m_bakedAsset; // Baked data restored frames refer to
+
     enum class State : uint8_t
     {
         Normal = 0,
@@ -54,6 +96,8 @@ private:
     };
     State                   m_state; // avoid to pass this parameter to public methods to prevent usage
 
+    std::string _getBakedCachePath() const;
+
 private:
     int _majorVersion;
     int _minorVersion;
@@ -81,10 +125,38 @@ public:
 	const Timelines_t&			getTimelines() const;
     Timelines_t&                getTimelines();
 
+    /// Allocator for the data parsed with the asset
+    GAFArena&                   getArena();
+    /// Filters of the asset shared by all its timelines
+    GAFFilterPool&              getFilterPool();
+    /// Bytes taken by parsed frames, object states and filters of all timelines
+    size_t                      getParsedDataSize() const;
+    /// Counts of parsed states and filters, shared ones included. States restored from a baked copy are not interned
+    GAFParsedDataStats          getParsedDataStats() const;
+
     static GAFAsset*            createWithBundle(const std::string& zipfilePath, const std::string& entryFile, GAFTextureLoadDelegate_t delegate, GAFLoader* customLoader = nullptr);
     static GAFAsset*            createWithBundle(const std::string& zipfilePath, const std::string& entryFile);
+    /// Loads a new asset every time it is called, GAFAssetCache is bypassed. Use GAFAssetCache::getAsset
+    /// to share one parsed asset and its textures between all users of the file
     static GAFAsset*            create(const std::string& gafFilePath, GAFTextureLoadDelegate_t delegate, GAFLoader* customLoader = nullptr);
     static GAFAsset*            create(const std::string& gafFilePath);
+    /// Loads only timelines with the given linkage names, timelines they contain and their atlases.
+    /// The first found timeline becomes the root one, see GAFLoader::setRootTimelines
+    static GAFAsset*            createWithRootTimelines(const std::string& gafFilePath, const std::vector<std::string>& linkageNames, GAFTextureLoadDelegate_t delegate = nullptr);
+
+    /// Parses asset and decodes its images on a worker thread, textures are created on the main thread
+    /// over several frames, see GAFTextureUploadScheduler.
+    /// @param callback is called on the main thread with autoreleased asset or nullptr if loading failed
+    /// @param progress is called on the main thread
+    /// @note texture load delegate is called on the worker thread
+    static GAFAssetLoadTask*    createAsync(const std::string& gafFilePath, GAFAssetLoadedDelegate_t callback, GAFTextureLoadDelegate_t delegate = nullptr, GAFAssetLoadProgressDelegate_t progress = nullptr);
+
+    /// Directory to keep baked copies of loaded assets in, e.g. FileUtils::getWritablePath(). Empty by default - baking is disabled.
+    /// Baked copy holds parsed animation frames and object states and is used instead of parsing them
+    /// while the GAF file stays the same. It is written on the first load and whenever the file changes
+    /// @note set it before any asset is loaded
+    static void                 setBakedCacheDirectory(const std::string& directory);
+    static const std::string&   getBakedCacheDirectory();
 
     static void                 getResourceReferences(const std::string& gafFilePath, std::vector<GAFResourcesInfo*> &dest);
     static void                 getResourceReferencesFromBundle(const std::string& zipfilePath, const std::string& entryFile, std::vector<GAFResourcesInfo*> &dest);
@@ -113,6 +185,18 @@ public:
     void                        setSoundDelegate(GAFSoundDelegate_t delagate);
 
     GAFAssetTextureManager*     getTextureManager();
+    /// Texture manager of the atlas of the timeline. Managers of atlases other than the loaded ones
+    /// are made on demand and load their images lazily
+    /// @returns nullptr for atlases of other scales of bundles, their images cannot be read after loading
+    GAFAssetTextureManager*     getTextureManager(GAFTimeline* timeline, GAFTextureAtlas* atlas);
+    /// Creates textures of all loaded atlases over the next frames within the GAFTextureUploadScheduler budget.
+    /// Objects created in the callback do not create textures on their own
+    /// @param callback is called with the asset once all textures are ready
+    void                        scheduleTexturesUpload(GAFAssetLoadedDelegate_t callback);
+    /// Releases textures of all atlas scales no object shows, see GAFAssetTextureManager::releaseUnusedTextures
+    void                        releaseUnusedTextures();
+    /// Bytes of images and textures of all atlas scales, see GAFAssetTextureManager::getMemoryConsumptionStat
+    size_t                      getTextureDataSize() const;
 
     const unsigned int getSceneFps() const;
     const unsigned int getSceneWidth() const;
@@ -0,0 +1,180 @@
+#include "GAFPrecompiled.h"
+#include "GAFAssetCache.h"
+#include "GAFAsset.h"
+#include "GAFAssetTextureManager.h"
+
+NS_GAF_BEGIN
+
+GAFAssetCache* GAFAssetCache::s_instance = nullptr;
+
+GAFAssetCache::GAFAssetCache()
+: m_memoryBudget(GAF_ASSET_CACHE_BUDGET)
+, m_parsedDataSize(0)
+, m_textureDataSize(0)
+{
+}
+
+GAFAssetCache::~GAFAssetCache()
+{
+    for (Entries_t::iterator i = m_entries.begin(), e = m_entries.end(); i != e; ++i)
+    {
+        i->asset->release();
+    }
+}
+
+GAFAssetCache* GAFAssetCache::getInstance()
+{
+    if (!s_instance)
+    {
+        s_instance = new GAFAssetCache();
+    }
+    return s_instance;
+}
+
+void GAFAssetCache::destroyInstance()
+{
+    delete s_instance;
+    s_instance = nullptr;
+}
+
+std::string GAFAssetCache::_makeKey(const std::string& fullPath, float atlasScale) const
+{
+    // Textures of another content scale factor come from other image files
+    char suffix[64];
+    snprintf(suffix, sizeof(suffix), "|%g|%g", atlasScale, cocos2d::Director::getInstance()->getContentScaleFactor());
+
+    return fullPath + suffix;
+}
+
+GAFAsset* GAFAssetCache::getAsset(const std::string& gafFilePath, float atlasScale /*= 1.f*/)
+{
+    const std::string key = _makeKey(cocos2d::FileUtils::getInstance()->fullPathForFilename(gafFilePath), atlasScale);
+
+    EntriesMap_t::iterator it = m_entriesMap.find(key);
+    if (it != m_entriesMap.end())
+    {
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->asset;
+    }
+
+    GAFAsset* asset = new GAFAsset();
+    asset->setDesiredAtlasScale(atlasScale);
+
+    if (!asset->initWithGAFFile(gafFilePath, nullptr))
+    {
+        asset->release();
+        return nullptr;
+    }
+
+    Entry entry = { key, asset, asset->getParsedDataSize(), asset->getTextureDataSize() };
+
+    m_entries.push_front(entry);
+    m_entriesMap[key] = m_entries.begin();
+
+    m_parsedDataSize += entry.parsedDataSize;
+    m_textureDataSize += entry.textureDataSize;
+
+    _trim();
+
+    return asset;
+}
+
+void GAFAssetCache::removeAsset(const std::string& gafFilePath, float atlasScale /*= 1.f*/)
+{
+    const std::string key = _makeKey(cocos2d::FileUtils::getInstance()->fullPathForFilename(gafFilePath), atlasScale);
+
+    EntriesMap_t::iterator it = m_entriesMap.find(key);
+    if (it != m_entriesMap.end())
+    {
+        _removeEntry(it->second);
+    }
+}
+
+void GAFAssetCache::removeUnusedAssets()
+{
+    for (Entries_t::iterator i = m_entries.begin(); i != m_entries.end();)
+    {
+        Entries_t::iterator entry = i++;
+
+        if (entry->asset->getReferenceCount() == 1)
+        {
+            _removeEntry(entry);
+        }
+    }
+}
+
+void GAFAssetCache::_removeEntry(Entries_t::iterator entry)
+{
+    m_parsedDataSize -= entry->parsedDataSize;
+    m_textureDataSize -= entry->textureDataSize;
+
+    entry->asset->release();
+
+    m_entriesMap.erase(entry->key);
+    m_entries.erase(entry);
+}
+
+void GAFAssetCache::_updateTextureDataSize()
+{
+    // Images are decoded and uploaded on first use and other atlas scales are loaded on demand, so the size changes after loading
+    m_textureDataSize = 0;
+
+    for (Entries_t::iterator i = m_entries.begin(), e = m_entries.end(); i != e; ++i)
+    {
+        i->textureDataSize = i->asset->getTextureDataSize();
+        m_textureDataSize += i->textureDataSize;
+    }
+}
+
+void GAFAssetCache::_trim()
+{
+    _updateTextureDataSize();
+
+    // The most recently requested asset is kept, it is about to be used
+    Entries_t::iterator i = m_entries.end();
+
+    while (m_parsedDataSize + m_textureDataSize > m_memoryBudget && i != m_entries.begin())
+    {
+        --i;
+
+        if (i == m_entries.begin())
+        {
+            break;
+        }
+
+        if (i->asset->getReferenceCount() == 1)
+        {
+            Entries_t::iterator entry = i++;
+            _removeEntry(entry);
+        }
+    }
+}
+
+void GAFAssetCache::setMemoryBudget(size_t bytes)
+{
+    m_memoryBudget = bytes;
+    _trim();
+}
+
+size_t GAFAssetCache::getMemoryBudget() const
+{
+    return m_memoryBudget;
+}
+
+size_t GAFAssetCache::getParsedDataSize() const
+{
+    return m_parsedDataSize;
+}
+
+size_t GAFAssetCache::getTextureDataSize()
+{
+    _updateTextureDataSize();
+    return m_textureDataSize;
+}
+
+size_t GAFAssetCache::getAssetsCount() const
+{
+    return m_entries.size();
+}
+
+NS_GAF_END
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "GAFMacros.h"
+
+#include <list>
+#include <unordered_map>
+
+NS_GAF_BEGIN
+
+class GAFAsset;
+
+/// Keeps loaded assets to share them between all their users.
+/// Assets are kept by resolved file path, atlas scale and content scale factor. The cache holds a reference
+/// to each asset, so an asset is unused when nobody else retains it. Unused assets are dropped
+/// least recently used first as soon as parsed data and textures of all cached assets exceed the memory budget.
+/// @note must be used on the main thread only
+class GAFAssetCache
+{
+private:
+    struct Entry
+    {
+        std::string     key;
+        GAFAsset*       asset;
+        size_t          parsedDataSize;
+        size_t          textureDataSize;
+    };
+
+    typedef std::list<Entry> Entries_t; // Most recently used first
+    typedef std::unordered_map<std::string, Entries_t::iterator> EntriesMap_t;
+
+    Entries_t           m_entries;
+    EntriesMap_t        m_entriesMap;
+
+    size_t              m_memoryBudget;
+    size_t              m_parsedDataSize;
+    size_t              m_textureDataSize;
+
+    static GAFAssetCache* s_instance;
+
+    GAFAssetCache();
+
+    std::string         _makeKey(const std::string& fullPath, float atlasScale) const;
+    void                _removeEntry(Entries_t::iterator entry);
+    void                _updateTextureDataSize();
+    void                _trim();
+
+public:
+    ~GAFAssetCache();
+
+    static GAFAssetCache* getInstance();
+    /// Releases all cached assets and the cache itself
+    static void         destroyInstance();
+
+    /// Returns the cached asset or loads it
+    /// @param atlasScale desired atlas scale the asset is loaded with
+    /// @returns asset that is retained by the cache only or nullptr if it cannot be loaded.
+    /// Retain the asset to keep it
+    GAFAsset*           getAsset(const std::string& gafFilePath, float atlasScale = 1.f);
+
+    /// Drops the asset from the cache, it is destroyed once its last user releases it
+    void                removeAsset(const std::string& gafFilePath, float atlasScale = 1.f);
+    /// Drops all assets that are not used
+    void                removeUnusedAssets();
+
+    /// Sets bytes of parsed data and textures to keep, unused assets above it are dropped. Default is GAF_ASSET_CACHE_BUDGET
+    void                setMemoryBudget(size_t bytes);
+    size_t              getMemoryBudget() const;
+
+    /// Bytes of parsed data of all cached assets
+    size_t              getParsedDataSize() const;
+    /// Bytes of images and textures of all cached assets, atlases of every scale included
+    size_t              getTextureDataSize();
+    size_t              getAssetsCount() const;
+};
+
+NS_GAF_END
\ No newline at end of file
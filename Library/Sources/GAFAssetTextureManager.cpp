@@ -1,11 +1,20 @@
 #include "GAFPrecompiled.h"
 
 #include "GAFAssetTextureManager.h"
+#include "GAFTextureRegistry.h"
+#include "GAFTextureAtlasElement.h"
+#include "GAFCompressedTexture.h"
+#include "GAFAlphaPremultiplier.h"
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 #include "renderer/CCTextureCache.h"
 #endif
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #if COCOS2D_VERSION <= 0x00030101
 #define ENABLE_GAF_MANUAL_PREMULTIPLY 1
 #else
@@ -15,24 +24,84 @@
 NS_GAF_BEGIN
 
 GAFAssetTextureManager::GAFAssetTextureManager():
-m_memoryConsumption(0)
+m_isDecoding(false),
+m_isDecodingCancelled(false),
+m_lazyDecoding(false),
+m_isBundle(false)
 {
 
 }
 
 GAFAssetTextureManager::~GAFAssetTextureManager()
 {
+    // The worker writes to the manager, it is stopped after the image it is decoding now
+    m_isDecodingCancelled = true;
+    if (m_decodingThread.joinable())
+    {
+        m_decodingThread.join();
+    }
+
+    for (size_t i = 0; i < m_decodedImages.size(); ++i)
+    {
+        m_decodedImages[i].second->release();
+    }
+
     GAF_SAFE_RELEASE_MAP(ImagesMap_t, m_images);
     GAF_SAFE_RELEASE_MAP(TexturesMap_t, m_textures);    
+
+    while (!m_registeredTextures.empty())
+    {
+        releaseRegisteredTexture(*m_registeredTextures.begin());
+    }
+}
+
+std::string GAFAssetTextureManager::getRegistryKey(size_t id) const
+{
+    ImagePaths_t::const_iterator it = m_imagePaths.find(id);
+    if (it == m_imagePaths.end())
+    {
+        return std::string();
+    }
+
+    return m_bundlePath.empty() ? it->second : m_bundlePath + "/" + it->second;
+}
+
+void GAFAssetTextureManager::releaseRegisteredTexture(size_t id)
+{
+    GAFTextureRegistry::getInstance()->releaseTexture(getRegistryKey(id));
+    m_registeredTextures.erase(id);
+}
+
+void GAFAssetTextureManager::setBundlePath(const std::string& path)
+{
+    m_bundlePath = path;
+}
+
+void GAFAssetTextureManager::setLazyDecoding(bool value)
+{
+    m_lazyDecoding = value;
+}
+
+bool GAFAssetTextureManager::isLazyDecoding() const
+{
+    return m_lazyDecoding;
 }
 
 void GAFAssetTextureManager::appendInfoFromTextureAtlas(GAFTextureAtlas* atlas)
 {
+	// Pages none of the elements is on are never drawn, e.g. pages of timelines that are not loaded
+	std::set<uint32_t> usedPages;
+	const GAFTextureAtlas::Elements_t& elements = atlas->getElements();
+	for (GAFTextureAtlas::Elements_t::const_iterator el = elements.begin(), ee = elements.end(); el != ee; ++el)
+	{
+		usedPages.insert(el->second->atlasIdx + 1);
+	}
+
 	GAFTextureAtlas::AtlasInfos_t atlasInfos = atlas->getAtlasInfos();
 	GAFTextureAtlas::AtlasInfos_t::const_iterator i = atlasInfos.begin(), e = atlasInfos.end();
 	for (; i != e; i++)
 	{
-		if (!isAtlasInfoPresent(*i))
+		if (usedPages.count(i->id) && !isAtlasInfoPresent(*i))
 		{
 			m_atlasInfos.push_back(*i);
 		}
@@ -52,80 +121,388 @@ bool GAFAssetTextureManager::isAtlasInfoPresent(const GAFTextureAtlas::AtlasInfo
 	return false;
 }
 
-void GAFAssetTextureManager::loadImages(const std::string& dir, GAFTextureLoadDelegate_t delegate, cocos2d::ZipFile* bundle)
+#if ENABLE_GAF_MANUAL_PREMULTIPLY
+static void premultiplyImage(cocos2d::Image* image)
+{
+	if (!image->isPremultipliedAlpha() && image->hasAlpha())
+	{
+		//Premultiply
+		unsigned char* begin = image->getData();
+		unsigned int width = image->getWidth();
+		unsigned int height = image->getHeight();
+		int Bpp = image->getBitPerPixel() / 8;
+
+		if (Bpp == 4)
+		{
+			GAFAlphaPremultiplier::premultiply(begin, static_cast<size_t>(width) * height);
+			return;
+		}
+
+		unsigned char* end = begin + width * height * Bpp;
+		for (auto data = begin; data < end; data += Bpp)
+		{
+			unsigned int* wordData = (unsigned int*)(data);
+			*wordData = CC_RGB_PREMULTIPLY_ALPHA(data[0], data[1], data[2], data[3]);
+		}
+	}
+}
+#endif
+
+void GAFAssetTextureManager::loadImages(const std::string& dir, GAFTextureLoadDelegate_t delegate, cocos2d::ZipFile* bundle, GAFImageLoadedDelegate_t imageLoaded)
 {
 	std::stable_sort(m_atlasInfos.begin(), m_atlasInfos.end(), GAFTextureAtlas::compareAtlasesById);
 
 	m_images.clear(); // check
+	m_isBundle = bundle != nullptr;
 	
-	if (!m_atlasInfos.empty())
+	if (m_atlasInfos.empty())
+	{
+		return;
+	}
+
+	struct ImageJob
 	{
-		for (unsigned int i = 0; i < m_atlasInfos.size(); ++i)
+		std::string path;
+		unsigned char* data; // Bundle entry, files are read by the decoding threads
+		ssize_t dataSize;
+		cocos2d::Image* image;
+		bool isShared;
+		bool isCompressed; // Made into a texture as is
+	};
+
+	std::vector<ImageJob> jobs;
+	jobs.reserve(m_atlasInfos.size());
+
+	// Neither the delegate nor the bundle is thread safe, sources are resolved up front
+	for (unsigned int i = 0; i < m_atlasInfos.size(); ++i)
+	{
+		GAFTextureAtlas::AtlasInfo& info = m_atlasInfos[i];
+
+		std::string source;
+
+		for (unsigned int j = 0; j < info.m_sources.size(); ++j)
+		{
+			GAFTextureAtlas::AtlasInfo::Source& aiSource = info.m_sources[j];
+			if (1.f == aiSource.csf)
+			{
+				source = aiSource.source;
+			}
+
+			if (aiSource.csf == cocos2d::CCDirector::getInstance()->getContentScaleFactor())
+			{
+				source = aiSource.source;
+				break;
+			}
+		}
+
+		ImageJob job = { cocos2d::FileUtils::getInstance()->fullPathFromRelativeFile(source.c_str(), dir.c_str()), nullptr, 0, nullptr, false, false };
+
+		if (delegate)
 		{
-			GAFTextureAtlas::AtlasInfo& info = m_atlasInfos[i];
+			job.path = delegate(job.path);
+		}
 
-			std::string source;
+		const std::string variant = GAFCompressedTexture::findVariant(job.path, bundle);
+		if (!variant.empty())
+		{
+			m_fallbackPaths[info.id] = job.path;
 
-			for (unsigned int j = 0; j < info.m_sources.size(); ++j)
+			// The bundle is closed after loading, the image is read now in case the variant cannot be used
+			if (bundle)
 			{
-				GAFTextureAtlas::AtlasInfo::Source& aiSource = info.m_sources[j];
-				if (1.f == aiSource.csf)
+				ssize_t fallbackSize = 0;
+				unsigned char* fallbackData = bundle->getFileData(job.path, &fallbackSize);
+				if (fallbackData && fallbackSize)
 				{
-					source = aiSource.source;
+					m_encodedFallbacks[info.id].fastSet(fallbackData, fallbackSize);
 				}
-
-				if (aiSource.csf == cocos2d::CCDirector::getInstance()->getContentScaleFactor())
+				else
 				{
-					source = aiSource.source;
-					break;
+					free(fallbackData);
 				}
 			}
 
-			cocos2d::Image* image = new cocos2d::Image();
-			std::string path = cocos2d::FileUtils::getInstance()->fullPathFromRelativeFile(source.c_str(), dir.c_str());
+			job.path = variant;
+			job.isCompressed = true;
+		}
+
+		m_imagePaths[info.id] = job.path;
+
+		// Texture of the image is made already, it is taken from the registry on upload
+		job.isShared = GAFTextureRegistry::getInstance()->hasTexture(getRegistryKey(info.id));
 
-			if (delegate)
+		// Entries of shared images are read too, the texture can be gone before it is taken and the bundle is closed by then
+		if (bundle)
+		{
+			job.data = bundle->getFileData(job.path, &job.dataSize);
+			if (!job.data || !job.dataSize)
 			{
-                path = delegate(path);
+				free(job.data);
+				break;
 			}
+		}
+
+		// The bundle is closed after loading, its entry is kept encoded till the first use
+		if (job.data && (m_lazyDecoding || job.isCompressed || job.isShared))
+		{
+			m_encodedImages[info.id].fastSet(job.data, job.dataSize);
+			job.data = nullptr;
+		}
 
-			if (!bundle)
+		if (m_lazyDecoding)
+		{
+			if (imageLoaded && !imageLoaded(i + 1, m_atlasInfos.size()))
 			{
-				image->initWithImageFile(path.c_str());
+				break;
+			}
+
+			continue;
+		}
+
+		jobs.push_back(job);
+	}
+
+	if (m_lazyDecoding)
+	{
+		return;
+	}
+
+	// Pages are decoded concurrently, each thread takes the next one that is not taken yet
+	std::atomic<size_t> nextJob(0);
+	std::atomic<bool> isAborted(false);
+	size_t loadedCount = 0;
+	std::mutex progressMutex;
+
+	auto decode = [&]()
+	{
+		for (size_t idx = nextJob++; idx < jobs.size() && !isAborted; idx = nextJob++)
+		{
+			ImageJob& job = jobs[idx];
+
+			if (job.isShared || job.isCompressed)
+			{
+				// Nothing to decode
+			}
+			else if (job.data)
+			{
+				job.image = new cocos2d::Image();
+				job.image->initWithImageData(job.data, job.dataSize);
+				free(job.data);
+				job.data = nullptr;
 			}
 			else
 			{
-				ssize_t sz = 0;
-				unsigned char* imgData = bundle->getFileData(path, &sz);
-				if (!imgData || !sz)
-					return;
+				job.image = new cocos2d::Image();
 
-				image->initWithImageData(imgData, sz);
+				cocos2d::Data data = cocos2d::FileUtils::getInstance()->getDataFromFile(job.path);
+				if (!data.isNull())
+				{
+					job.image->initWithImageData(data.getBytes(), data.getSize());
+				}
 			}
 
-			m_memoryConsumption += image->getDataLen();
-
 #if ENABLE_GAF_MANUAL_PREMULTIPLY
-			if (!image->isPremultipliedAlpha() && image->hasAlpha())
+			if (job.image)
 			{
-				//Premultiply
-				unsigned char* begin = image->getData();
-				unsigned int width = image->getWidth();
-				unsigned int height = image->getHeight();
-				int Bpp = image->getBitPerPixel() / 8;
-				unsigned char* end = begin + width * height * Bpp;
-				for (auto data = begin; data < end; data += Bpp)
+				premultiplyImage(job.image);
+			}
+#endif
+
+			if (imageLoaded)
+			{
+				std::lock_guard<std::mutex> lock(progressMutex);
+				if (!isAborted && !imageLoaded(++loadedCount, m_atlasInfos.size()))
 				{
-					unsigned int* wordData = (unsigned int*)(data);
-					*wordData = CC_RGB_PREMULTIPLY_ALPHA(data[0], data[1], data[2], data[3]);
+					isAborted = true;
 				}
 			}
-#endif
-			m_images[info.id] = image;
+		}
+	};
+
+	const size_t threadsCount = std::min<size_t>(std::thread::hardware_concurrency(), jobs.size());
+
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < threadsCount; ++i)
+	{
+		threads.push_back(std::thread(decode));
+	}
+
+	decode();
+
+	for (std::thread& t : threads)
+	{
+		t.join();
+	}
+
+	// Images are stored in the page order no matter which thread decoded them
+	for (size_t i = 0, e = jobs.size(); i < e; ++i)
+	{
+		if (jobs[i].image)
+		{
+			m_images[m_atlasInfos[i].id] = jobs[i].image;
+		}
+		else
+		{
+			free(jobs[i].data); // Shared or compressed image or loading was aborted before the page was taken
 		}
 	}
 }
 
+void GAFAssetTextureManager::uploadImages()
+{
+    for (ImagePaths_t::const_iterator i = m_imagePaths.begin(), e = m_imagePaths.end(); i != e; ++i)
+    {
+        getTextureById(static_cast<uint32_t>(i->first));
+    }
+}
+
+void GAFAssetTextureManager::decodeImagesAsync()
+{
+    if (m_isDecoding)
+    {
+        return;
+    }
+
+    struct DecodeJob
+    {
+        size_t id;
+        std::string path;
+        cocos2d::Data data; // Copy of the bundle entry, the original one stays for getTextureById
+    };
+
+    std::shared_ptr<std::vector<DecodeJob>> jobs = std::make_shared<std::vector<DecodeJob>>();
+    GAFTextureRegistry* registry = GAFTextureRegistry::getInstance();
+
+    for (ImagePaths_t::const_iterator i = m_imagePaths.begin(), e = m_imagePaths.end(); i != e; ++i)
+    {
+        // Decoded already, to be taken from the registry or compressed
+        if (m_textures.count(i->first) || m_images.count(i->first) || registry->hasTexture(getRegistryKey(i->first)) || m_fallbackPaths.count(i->first))
+        {
+            continue;
+        }
+
+        DecodeJob job;
+        job.id = i->first;
+        job.path = i->second;
+
+        EncodedImages_t::const_iterator encodedIt = m_encodedImages.find(i->first);
+        if (encodedIt != m_encodedImages.end())
+        {
+            job.data = encodedIt->second;
+        }
+
+        jobs->push_back(job);
+    }
+
+    if (jobs->empty())
+    {
+        return;
+    }
+
+    // The previous worker is done already, see m_isDecoding
+    if (m_decodingThread.joinable())
+    {
+        m_decodingThread.join();
+    }
+
+    m_isDecoding = true;
+
+    // The destructor stops and joins the worker
+    m_decodingThread = std::thread([this, jobs]()
+    {
+        for (size_t i = 0; i < jobs->size() && !m_isDecodingCancelled; ++i)
+        {
+            DecodeJob& job = (*jobs)[i];
+
+            if (job.data.isNull())
+            {
+                job.data = cocos2d::FileUtils::getInstance()->getDataFromFile(job.path);
+            }
+
+            cocos2d::Image* image = new cocos2d::Image();
+            if (!job.data.isNull())
+            {
+                image->initWithImageData(job.data.getBytes(), job.data.getSize());
+            }
+            job.data.clear();
+
+#if ENABLE_GAF_MANUAL_PREMULTIPLY
+            premultiplyImage(image);
+#endif
+
+            std::lock_guard<std::mutex> lock(m_decodedImagesMutex);
+            m_decodedImages.push_back(std::make_pair(job.id, image));
+        }
+
+        m_isDecoding = false;
+    });
+}
+
+bool GAFAssetTextureManager::isDecoding() const
+{
+    return m_isDecoding;
+}
+
+bool GAFAssetTextureManager::uploadNextImage()
+{
+    size_t id = 0;
+    cocos2d::Image* image = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(m_decodedImagesMutex);
+        if (!m_decodedImages.empty())
+        {
+            id = m_decodedImages.front().first;
+            image = m_decodedImages.front().second;
+            m_decodedImages.erase(m_decodedImages.begin());
+        }
+    }
+
+    if (image)
+    {
+        // The texture could be needed before the image was decoded
+        if (m_textures.count(id) || m_images.count(id))
+        {
+            image->release();
+        }
+        else
+        {
+            m_images[id] = image;
+            getTextureById(static_cast<uint32_t>(id));
+        }
+        return true;
+    }
+
+    if (m_isDecoding)
+    {
+        return false;
+    }
+
+    // Images decoded while loading, textures shared by other assets and whatever was not decoded
+    for (ImagePaths_t::const_iterator i = m_imagePaths.begin(), e = m_imagePaths.end(); i != e; ++i)
+    {
+        if (!m_textures.count(i->first))
+        {
+            getTextureById(static_cast<uint32_t>(i->first));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool GAFAssetTextureManager::areTexturesReady() const
+{
+    for (ImagePaths_t::const_iterator i = m_imagePaths.begin(), e = m_imagePaths.end(); i != e; ++i)
+    {
+        if (!m_textures.count(i->first))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 cocos2d::Texture2D* GAFAssetTextureManager::getTextureById(uint32_t id)
 {
 	TexturesMap_t::const_iterator txIt = m_textures.find(id);
@@ -133,27 +510,168 @@ cocos2d::Texture2D* GAFAssetTextureManager::getTextureById(uint32_t id)
 	{
 		return txIt->second;
 	}
-    
-    // check if still not created
-    ImagesMap_t::const_iterator imagesIt = m_images.find(id);
-    if (imagesIt != m_images.end())
+
+    ImagePaths_t::const_iterator pathIt = m_imagePaths.find(id);
+    if (pathIt == m_imagePaths.end())
     {
-        cocos2d::Texture2D * texture = new cocos2d::Texture2D();
-        texture->initWithImage(imagesIt->second);
+        return nullptr;
+    }
+
+    GAFTextureRegistry* registry = GAFTextureRegistry::getInstance();
+    ImagesMap_t::iterator imagesIt = m_images.find(id);
+
+    // Another asset has made the texture of the same image, own copy is not needed
+    const std::string registryKey = getRegistryKey(id);
+    cocos2d::Texture2D* texture = registry->acquireTexture(registryKey);
+    if (texture)
+    {
+        texture->retain();
         m_textures[id] = texture;
+        m_registeredTextures.insert(id);
+
+        if (imagesIt != m_images.end())
+        {
+            imagesIt->second->release();
+            m_images.erase(imagesIt);
+        }
+        m_encodedImages.erase(id);
+        m_encodedFallbacks.erase(id);
+
+        return texture;
+    }
+
+    ImagePaths_t::iterator fallbackIt = m_fallbackPaths.find(id);
+    if (fallbackIt != m_fallbackPaths.end())
+    {
+        texture = createCompressedTexture(id);
+        if (texture)
+        {
+            m_textures[id] = texture;
+            registry->addTexture(registryKey, texture);
+            m_registeredTextures.insert(id);
+            m_encodedFallbacks.erase(id);
+            return texture;
+        }
+
+        // Broken variant, the image it was made of is used instead
+        EncodedImages_t::iterator fallbackDataIt = m_encodedFallbacks.find(id);
+        if (m_isBundle && fallbackDataIt == m_encodedFallbacks.end())
+        {
+            // The atlas is left without a texture instead of being tried again on every call
+            CCLOGERROR("Compressed image %s cannot be used and the bundle has no %s", pathIt->second.c_str(), fallbackIt->second.c_str());
+            m_fallbackPaths.erase(fallbackIt);
+            m_imagePaths.erase(id);
+            return nullptr;
+        }
+
+        CCLOGERROR("Compressed image %s cannot be used, falling back to %s", pathIt->second.c_str(), fallbackIt->second.c_str());
+        if (fallbackDataIt != m_encodedFallbacks.end())
+        {
+            m_encodedImages[id] = std::move(fallbackDataIt->second);
+            m_encodedFallbacks.erase(fallbackDataIt);
+        }
+        m_imagePaths[id] = fallbackIt->second;
+        m_fallbackPaths.erase(fallbackIt);
+        return getTextureById(id);
+    }
+
+    cocos2d::Image* image = nullptr;
+    if (imagesIt != m_images.end())
+    {
+        image = imagesIt->second;
+        m_images.erase(imagesIt);
+    }
+    else
+    {
+        // Lazy decoding, or the image was shared while loading but its texture has been released since then
+        image = decodeImage(id);
+    }
+
+    texture = new cocos2d::Texture2D();
+    texture->initWithImage(image);
+    m_textures[id] = texture;
 #if CC_ENABLE_CACHE_TEXTURE_DATA
-        cocos2d::VolatileTextureMgr::addImage(texture, imagesIt->second);
+#if !GAF_KEEP_IMAGES_FOR_CONTEXT_LOSS && !ENABLE_GAF_MANUAL_PREMULTIPLY
+    // Files can be read again on context loss, so the decoded copy is not kept for it.
+    // Manually premultiplied images are always kept, a reloaded file would not be premultiplied
+    if (!m_isBundle)
+    {
+        cocos2d::VolatileTextureMgr::addImageTexture(texture, pathIt->second);
+    }
+    else
 #endif
-        imagesIt->second->release();
-        m_images.erase(imagesIt);
-        return texture;
+    {
+        cocos2d::VolatileTextureMgr::addImage(texture, image);
+    }
+#endif
+    image->release();
+
+    registry->addTexture(registryKey, texture);
+    m_registeredTextures.insert(id);
+
+    return texture;
+}
+
+cocos2d::Image* GAFAssetTextureManager::decodeImage(size_t id)
+{
+    cocos2d::Image* image = new cocos2d::Image();
+
+    EncodedImages_t::iterator encodedIt = m_encodedImages.find(id);
+    if (encodedIt != m_encodedImages.end())
+    {
+        image->initWithImageData(encodedIt->second.getBytes(), encodedIt->second.getSize());
+        m_encodedImages.erase(encodedIt);
+    }
+    else
+    {
+        image->initWithImageFile(m_imagePaths[id]);
+    }
+
+#if ENABLE_GAF_MANUAL_PREMULTIPLY
+    premultiplyImage(image);
+#endif
+
+    return image;
+}
+
+cocos2d::Texture2D* GAFAssetTextureManager::createCompressedTexture(size_t id)
+{
+    GAFKTXImage image;
+    bool isLoaded = false;
+
+    EncodedImages_t::iterator encodedIt = m_encodedImages.find(id);
+    if (encodedIt != m_encodedImages.end())
+    {
+        isLoaded = image.initWithData(encodedIt->second);
+        m_encodedImages.erase(encodedIt);
+    }
+    else
+    {
+        isLoaded = image.initWithFile(m_imagePaths[id]);
+    }
+
+    if (!isLoaded)
+    {
+        return nullptr;
+    }
+
+    GAFCompressedTexture* texture = new GAFCompressedTexture();
+    if (!texture->initWithKTXImage(image))
+    {
+        texture->release();
+        return nullptr;
     }
 
-    return nullptr;
+    return texture;
 }
 
 bool GAFAssetTextureManager::swapTexture(uint32_t id, cocos2d::Texture2D *texture)
 {
+    if (m_registeredTextures.count(id))
+    {
+        releaseRegisteredTexture(id);
+    }
+
     TexturesMap_t::const_iterator txIt = m_textures.find(id);
     if (txIt != m_textures.end())
     {
@@ -167,6 +685,8 @@ bool GAFAssetTextureManager::swapTexture(uint32_t id, cocos2d::Texture2D *textur
         imagesIt->second->release();
         m_images.erase(imagesIt);
     }
+    m_encodedImages.erase(id);
+    m_encodedFallbacks.erase(id);
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     // NOTE: this should not work with cocos2d::VolatileTextureMgr
@@ -178,9 +698,73 @@ bool GAFAssetTextureManager::swapTexture(uint32_t id, cocos2d::Texture2D *textur
     return true;
 }
 
+void GAFAssetTextureManager::releaseUnusedTextures()
+{
+    // Bundle entries cannot be read again
+    if (m_isBundle)
+    {
+        return;
+    }
+
+    for (TexturesMap_t::iterator i = m_textures.begin(); i != m_textures.end();)
+    {
+        TexturesMap_t::iterator txIt = i++;
+
+        // The manager and GAFTextureRegistry hold one reference each, any other one is a user of the texture
+        if (m_registeredTextures.count(txIt->first) && txIt->second->getReferenceCount() == 2)
+        {
+            releaseRegisteredTexture(txIt->first);
+            txIt->second->release();
+            m_textures.erase(txIt);
+        }
+    }
+}
+
+uint32_t GAFAssetTextureManager::getCpuMemoryConsumption() const
+{
+    size_t bytes = 0;
+
+    for (ImagesMap_t::const_iterator i = m_images.begin(), e = m_images.end(); i != e; ++i)
+    {
+        bytes += static_cast<size_t>(i->second->getDataLen());
+    }
+
+    for (EncodedImages_t::const_iterator i = m_encodedImages.begin(), e = m_encodedImages.end(); i != e; ++i)
+    {
+        bytes += static_cast<size_t>(i->second.getSize());
+    }
+
+    for (EncodedImages_t::const_iterator i = m_encodedFallbacks.begin(), e = m_encodedFallbacks.end(); i != e; ++i)
+    {
+        bytes += static_cast<size_t>(i->second.getSize());
+    }
+
+    return static_cast<uint32_t>(bytes);
+}
+
+uint32_t GAFAssetTextureManager::getGpuMemoryConsumption() const
+{
+    size_t bytes = 0;
+
+    for (TexturesMap_t::const_iterator i = m_textures.begin(), e = m_textures.end(); i != e; ++i)
+    {
+        const GAFCompressedTexture* compressed = dynamic_cast<const GAFCompressedTexture*>(i->second);
+        if (compressed)
+        {
+            bytes += compressed->getDataSize();
+            continue;
+        }
+
+        const cocos2d::Texture2D* texture = i->second;
+        bytes += static_cast<size_t>(texture->getPixelsWide()) * texture->getPixelsHigh() * texture->getBitsPerPixelForFormat() / 8;
+    }
+
+    return static_cast<uint32_t>(bytes);
+}
+
 uint32_t GAFAssetTextureManager::getMemoryConsumptionStat() const
 {
-	return m_memoryConsumption;
+	return getCpuMemoryConsumption() + getGpuMemoryConsumption();
 }
 
 NS_GAF_END
\ No newline at end of file
@@ -3,6 +3,11 @@
 #include "GAFTextureAtlas.h"
 #include "GAFDelegates.h"
 
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
 NS_GAF_BEGIN
 
 class GAFAssetTextureManager : public cocos2d::Ref
@@ -12,15 +17,50 @@ public:
 	~GAFAssetTextureManager();
 
 	void					appendInfoFromTextureAtlas(GAFTextureAtlas* atlas);
-	void					loadImages(const std::string& dir, GAFTextureLoadDelegate_t delegate, cocos2d::ZipFile* bundle = nullptr);
+	/// Decoding of every image is deferred to the first getTextureById of its atlas, which decodes it on the calling thread.
+	/// Disabled by default - loadImages decodes all images concurrently
+	/// @note set it before loadImages
+	void					setLazyDecoding(bool value);
+	bool					isLazyDecoding() const;
+
+	/// Full path of the bundle images are read from. Textures of its entries are shared under it,
+	/// so that same named entries of other bundles get textures of their own. Set it before loadImages
+	void					setBundlePath(const std::string& path);
+
+	void					loadImages(const std::string& dir, GAFTextureLoadDelegate_t delegate, cocos2d::ZipFile* bundle = nullptr, GAFImageLoadedDelegate_t imageLoaded = nullptr);
+	/// Creates textures for all atlases. Must be called on the main thread
+	void					uploadImages();
+	/// Starts decoding images of atlases that have no texture yet on a worker thread, see GAFTextureUploadScheduler
+	void					decodeImagesAsync();
+	bool					isDecoding() const;
+	/// Creates one texture of a decoded image, or of any atlas without one when nothing is being decoded.
+	/// Must be called on the main thread
+	/// @returns false if there is nothing to upload right now
+	bool					uploadNextImage();
+	/// True when every atlas has a texture
+	bool					areTexturesReady() const;
+	/// Textures of images that are already used by other assets are shared with them, see GAFTextureRegistry.
+	/// Compressed variants of images the GPU supports are used instead of them, see GAFCompressedTexture
 	cocos2d::Texture2D*		getTextureById(uint32_t id);
     bool                    swapTexture(uint32_t id, cocos2d::Texture2D* texture);
+	/// Releases textures nothing but this manager holds, they are made again by getTextureById on demand.
+	/// Textures of bundles and swapped ones are kept
+	void					releaseUnusedTextures();
     
+	/// Bytes of images kept in memory, both decoded and still encoded
+	uint32_t				getCpuMemoryConsumption() const;
+	/// Bytes of textures used by the asset, shared ones included
+	uint32_t				getGpuMemoryConsumption() const;
+	/// Sum of CPU and GPU memory consumption
 	uint32_t				getMemoryConsumptionStat() const;
 
 private:
 	typedef std::map<size_t, cocos2d::Image*> ImagesMap_t;
 	typedef std::map<size_t, cocos2d::Texture2D*> TexturesMap_t;
+	typedef std::map<size_t, std::string> ImagePaths_t;
+	typedef std::map<size_t, cocos2d::Data> EncodedImages_t;
+	typedef std::vector<std::pair<size_t, cocos2d::Image*>> DecodedImages_t;
+	typedef std::set<size_t> RegisteredTextures_t;
 
 	bool isAtlasInfoPresent(const GAFTextureAtlas::AtlasInfo &ai);
 
@@ -29,7 +69,28 @@ private:
 	ImagesMap_t m_images;
 	TexturesMap_t m_textures;
 
-	uint32_t m_memoryConsumption;
+	ImagePaths_t m_imagePaths; // Resolved image of every atlas
+	ImagePaths_t m_fallbackPaths; // Images of atlases that have a compressed variant, used if the variant fails
+	EncodedImages_t m_encodedImages; // Bundle entries waiting to be decoded
+	EncodedImages_t m_encodedFallbacks; // Bundle entries of m_fallbackPaths, kept till the variant is made into a texture
+
+	DecodedImages_t m_decodedImages; // Made by decodeImagesAsync, waiting for uploadNextImage
+	std::mutex m_decodedImagesMutex;
+	std::atomic<bool> m_isDecoding;
+	std::atomic<bool> m_isDecodingCancelled; // Set when the manager is released, the worker stops after the current image
+	std::thread m_decodingThread;
+	RegisteredTextures_t m_registeredTextures; // Atlases this manager uses from GAFTextureRegistry
+
+	std::string m_bundlePath;
+
+	/// Name of the image of the atlas in GAFTextureRegistry
+	std::string getRegistryKey(size_t id) const;
+	void releaseRegisteredTexture(size_t id);
+	cocos2d::Image* decodeImage(size_t id);
+	cocos2d::Texture2D* createCompressedTexture(size_t id);
+
+	bool m_lazyDecoding;
+	bool m_isBundle;
 };
 
 NS_GAF_END
\ No newline at end of file
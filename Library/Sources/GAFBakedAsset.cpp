@@ -0,0 +1,488 @@
+#include "GAFPrecompiled.h"
+#include "GAFBakedAsset.h"
+#include "GAFAsset.h"
+#include "GAFTimeline.h"
+#include "GAFAnimationFrame.h"
+#include "GAFStateStore.h"
+#include "GAFFilterData.h"
+#include "GAFArena.h"
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+#include "../external/xxhash/xxhash.h"
+
+NS_GAF_BEGIN
+
+// Baked data layout. All values are 32 bit wide and 4 byte aligned, byte order is native
+//
+// BakedHeader
+// TimelineEntry[timelinesCount] ordered by timeline id, offsets point to the timeline sections
+// Timeline section:
+//     statesCount, filterListsCount, framesCount
+//     state store arrays: objectIds, maskObjectIds, zIndices, transforms, colorMults, colorOffsets, filterLists
+//     filter lists except the empty one: filtersCount, then type and parameters of every filter
+//     frames: isKeyframe, statesCount, actionsCount, states, slots (delta frames only),
+//             actions: type, scope, paramsCount, params
+// Strings are stored as their length followed by characters padded to 4 bytes
+
+static const uint32_t BakedMagic = 0x42464147; // "GAFB"
+static const uint32_t BakedVersion = 1;
+
+struct BakedHeader
+{
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    sourceHash;
+    uint32_t    sourceLength;
+    uint32_t    dataHash; // Everything after the header
+    uint32_t    timelinesCount;
+};
+
+static_assert(sizeof(cocos2d::AffineTransform) == 6 * sizeof(float), "Transforms are baked as 6 floats");
+
+class BakedWriter
+{
+private:
+    std::vector<unsigned char> m_data;
+
+public:
+    size_t                  size() const { return m_data.size(); }
+    const unsigned char*    data() const { return m_data.data(); }
+
+    void write(const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        m_data.insert(m_data.end(), bytes, bytes + size);
+    }
+
+    void writeU32(uint32_t value) { write(&value, sizeof(value)); }
+    void writeFloat(float value) { write(&value, sizeof(value)); }
+
+    void writeString(const std::string& value)
+    {
+        writeU32(static_cast<uint32_t>(value.size()));
+        write(value.data(), value.size());
+        m_data.resize((m_data.size() + 3) & ~static_cast<size_t>(3), 0);
+    }
+
+    void setU32(size_t position, uint32_t value)
+    {
+        memcpy(&m_data[position], &value, sizeof(value));
+    }
+};
+
+class BakedReader
+{
+private:
+    const unsigned char*    m_data;
+    const unsigned char*    m_end;
+
+public:
+    BakedReader(const unsigned char* data, const unsigned char* end)
+    : m_data(data)
+    , m_end(end)
+    {
+    }
+
+    template <typename T>
+    const T* readArray(size_t count)
+    {
+        assert(m_data + count * sizeof(T) <= m_end);
+
+        const T* retval = reinterpret_cast<const T*>(m_data);
+        m_data += count * sizeof(T);
+        return retval;
+    }
+
+    uint32_t readU32() { return *readArray<uint32_t>(1); }
+    float readFloat() { return *readArray<float>(1); }
+
+    void readString(std::string* out)
+    {
+        const uint32_t length = readU32();
+        out->assign(readArray<char>((length + 3) & ~3u), length);
+    }
+};
+
+static void writeFilter(BakedWriter& out, const GAFFilterData* filter)
+{
+    out.writeU32(static_cast<uint32_t>(filter->getType()));
+
+    switch (filter->getType())
+    {
+    case GAFFilterType::Blur:
+    {
+        const GAFBlurFilterData* blur = static_cast<const GAFBlurFilterData*>(filter);
+        out.writeFloat(blur->blurSize.width);
+        out.writeFloat(blur->blurSize.height);
+        break;
+    }
+    case GAFFilterType::ColorMatrix:
+    {
+        const GAFColorColorMatrixFilterData* colorMatrix = static_cast<const GAFColorColorMatrixFilterData*>(filter);
+        out.write(colorMatrix->matrix, sizeof(colorMatrix->matrix));
+        out.write(colorMatrix->matrix2, sizeof(colorMatrix->matrix2));
+        break;
+    }
+    case GAFFilterType::Glow:
+    {
+        const GAFGlowFilterData* glow = static_cast<const GAFGlowFilterData*>(filter);
+        out.writeFloat(glow->color.r);
+        out.writeFloat(glow->color.g);
+        out.writeFloat(glow->color.b);
+        out.writeFloat(glow->color.a);
+        out.writeFloat(glow->blurSize.width);
+        out.writeFloat(glow->blurSize.height);
+        out.writeFloat(glow->strength);
+        out.writeU32(glow->innerGlow);
+        out.writeU32(glow->knockout);
+        break;
+    }
+    case GAFFilterType::DropShadow:
+    {
+        const GAFDropShadowFilterData* shadow = static_cast<const GAFDropShadowFilterData*>(filter);
+        out.writeFloat(shadow->color.r);
+        out.writeFloat(shadow->color.g);
+        out.writeFloat(shadow->color.b);
+        out.writeFloat(shadow->color.a);
+        out.writeFloat(shadow->blurSize.width);
+        out.writeFloat(shadow->blurSize.height);
+        out.writeFloat(shadow->angle);
+        out.writeFloat(shadow->distance);
+        out.writeFloat(shadow->strength);
+        out.writeU32(shadow->innerShadow);
+        out.writeU32(shadow->knockout);
+        break;
+    }
+    }
+}
+
+static GAFFilterData* readFilter(BakedReader& in, GAFArena& arena)
+{
+    const GAFFilterType type = static_cast<GAFFilterType>(in.readU32());
+
+    switch (type)
+    {
+    case GAFFilterType::Blur:
+    {
+        GAFBlurFilterData* blur = arena.create<GAFBlurFilterData>();
+        blur->blurSize.width = in.readFloat();
+        blur->blurSize.height = in.readFloat();
+        return blur;
+    }
+    case GAFFilterType::ColorMatrix:
+    {
+        GAFColorColorMatrixFilterData* colorMatrix = arena.create<GAFColorColorMatrixFilterData>();
+        memcpy(colorMatrix->matrix, in.readArray<float>(16), sizeof(colorMatrix->matrix));
+        memcpy(colorMatrix->matrix2, in.readArray<float>(4), sizeof(colorMatrix->matrix2));
+        return colorMatrix;
+    }
+    case GAFFilterType::Glow:
+    {
+        GAFGlowFilterData* glow = arena.create<GAFGlowFilterData>();
+        glow->color.r = in.readFloat();
+        glow->color.g = in.readFloat();
+        glow->color.b = in.readFloat();
+        glow->color.a = in.readFloat();
+        glow->blurSize.width = in.readFloat();
+        glow->blurSize.height = in.readFloat();
+        glow->strength = in.readFloat();
+        glow->innerGlow = in.readU32() != 0;
+        glow->knockout = in.readU32() != 0;
+        return glow;
+    }
+    case GAFFilterType::DropShadow:
+    {
+        GAFDropShadowFilterData* shadow = arena.create<GAFDropShadowFilterData>();
+        shadow->color.r = in.readFloat();
+        shadow->color.g = in.readFloat();
+        shadow->color.b = in.readFloat();
+        shadow->color.a = in.readFloat();
+        shadow->blurSize.width = in.readFloat();
+        shadow->blurSize.height = in.readFloat();
+        shadow->angle = in.readFloat();
+        shadow->distance = in.readFloat();
+        shadow->strength = in.readFloat();
+        shadow->innerShadow = in.readU32() != 0;
+        shadow->knockout = in.readU32() != 0;
+        return shadow;
+    }
+    }
+
+    assert("Unknown baked filter type" && false);
+    return nullptr;
+}
+
+static void writeTimeline(BakedWriter& out, const GAFTimeline* timeline)
+{
+    const GAFStateStore& store = timeline->getStates();
+    const AnimationFrames_t& frames = timeline->getAnimationFrames();
+
+    const size_t statesCount = store.size();
+    const uint32_t filterListsCount = static_cast<uint32_t>(store.getFilterListsCount());
+
+    out.writeU32(static_cast<uint32_t>(statesCount));
+    out.writeU32(filterListsCount);
+    out.writeU32(static_cast<uint32_t>(frames.size()));
+
+    out.write(store.getObjectIds(), statesCount * sizeof(uint32_t));
+    out.write(store.getMaskObjectIds(), statesCount * sizeof(uint32_t));
+    out.write(store.getZIndices(), statesCount * sizeof(int));
+    out.write(store.getTransforms(), statesCount * sizeof(cocos2d::AffineTransform));
+    out.write(store.getColorMults(), statesCount * 4 * sizeof(float));
+    out.write(store.getColorOffsets(), statesCount * 4 * sizeof(float));
+    out.write(store.getFilterLists(), statesCount * sizeof(uint32_t));
+
+    for (uint32_t i = 1; i < filterListsCount; ++i)
+    {
+        const Filters_t& filters = store.getFilterList(i);
+
+        out.writeU32(static_cast<uint32_t>(filters.size()));
+        for (const GAFFilterData* filter : filters)
+        {
+            writeFilter(out, filter);
+        }
+    }
+
+    for (const GAFAnimationFrame* frame : frames)
+    {
+        const uint32_t count = frame->getObjectStatesCount();
+        const GAFAnimationFrame::TimelineActions_t& actions = frame->getTimelineActions();
+
+        out.writeU32(frame->isKeyframe());
+        out.writeU32(count);
+        out.writeU32(static_cast<uint32_t>(actions.size()));
+
+        out.write(frame->getObjectStates(), count * sizeof(uint32_t));
+        if (!frame->isKeyframe())
+        {
+            out.write(frame->getStateSlots(), count * sizeof(uint32_t));
+        }
+
+        for (const GAFTimelineAction& action : actions)
+        {
+            const ActionParams_t& params = action.getParams();
+
+            out.writeU32(static_cast<uint32_t>(action.getType()));
+            out.writeString(action.getScope());
+            out.writeU32(static_cast<uint32_t>(params.size()));
+            for (const std::string& param : params)
+            {
+                out.writeString(param);
+            }
+        }
+    }
+}
+
+GAFBakedAsset::GAFBakedAsset()
+: m_timelines(nullptr)
+, m_timelinesCount(0)
+{
+}
+
+GAFBakedAsset::~GAFBakedAsset()
+{
+}
+
+bool GAFBakedAsset::open(const std::string& filename, uint32_t sourceHash, unsigned long sourceLength)
+{
+    m_timelines = nullptr;
+    m_timelinesCount = 0;
+
+    if (!cocos2d::FileUtils::getInstance()->isFileExist(filename) || !m_file.openRaw(filename))
+    {
+        return false;
+    }
+
+    const unsigned long length = m_file.getDataLength();
+
+    BakedHeader header;
+    bool isValid = length >= sizeof(BakedHeader);
+
+    if (isValid)
+    {
+        memcpy(&header, m_file.getDataAt(0), sizeof(BakedHeader));
+
+        isValid = header.magic == BakedMagic
+            && header.version == BakedVersion
+            && header.sourceHash == sourceHash
+            && header.sourceLength == sourceLength
+            && (length - sizeof(BakedHeader)) / sizeof(TimelineEntry) >= header.timelinesCount
+            && XXH32(m_file.getDataAt(sizeof(BakedHeader)), length - sizeof(BakedHeader), 0) == header.dataHash;
+    }
+
+    if (!isValid)
+    {
+        CCLOG("Baked GAF data %s is outdated and will be rebuilt", filename.c_str());
+        m_file.close();
+        return false;
+    }
+
+    m_timelines = reinterpret_cast<const TimelineEntry*>(m_file.getDataAt(sizeof(BakedHeader)));
+    m_timelinesCount = header.timelinesCount;
+
+    return true;
+}
+
+const GAFBakedAsset::TimelineEntry* GAFBakedAsset::_findTimeline(uint32_t id) const
+{
+    const TimelineEntry* end = m_timelines + m_timelinesCount;
+    const TimelineEntry* it = std::lower_bound(m_timelines, end, id, [](const TimelineEntry& entry, uint32_t value) { return entry.id < value; });
+
+    return (it != end && it->id == id) ? it : nullptr;
+}
+
+bool GAFBakedAsset::hasTimeline(uint32_t id) const
+{
+    return _findTimeline(id) != nullptr;
+}
+
+bool GAFBakedAsset::restoreTimeline(GAFTimeline* timeline, GAFArena& arena) const
+{
+    const TimelineEntry* entry = _findTimeline(timeline->getId());
+    if (!entry)
+    {
+        return false;
+    }
+
+    GAFStateStore& store = timeline->getStates();
+
+    assert(store.size() == 0 && timeline->getAnimationFrames().empty());
+
+    BakedReader in(m_file.getDataAt(entry->offset), m_file.getDataAt(0) + m_file.getDataLength());
+
+    const uint32_t statesCount = in.readU32();
+    const uint32_t filterListsCount = in.readU32();
+    const uint32_t framesCount = in.readU32();
+
+    const uint32_t* objectIds = in.readArray<uint32_t>(statesCount);
+    const uint32_t* maskObjectIds = in.readArray<uint32_t>(statesCount);
+    const int* zIndices = in.readArray<int>(statesCount);
+    const cocos2d::AffineTransform* transforms = in.readArray<cocos2d::AffineTransform>(statesCount);
+    const float* colorMults = in.readArray<float>(statesCount * 4);
+    const float* colorOffsets = in.readArray<float>(statesCount * 4);
+    const uint32_t* filterLists = in.readArray<uint32_t>(statesCount);
+
+    store.assign(statesCount, objectIds, maskObjectIds, zIndices, transforms, colorMults, colorOffsets, filterLists);
+
+    for (uint32_t i = 1; i < filterListsCount; ++i)
+    {
+        Filters_t filters(in.readU32());
+        for (GAFFilterData*& filter : filters)
+        {
+            filter = readFilter(in, arena);
+        }
+
+        store.pushFilterList(filters);
+    }
+
+    for (uint32_t i = 0; i < framesCount; ++i)
+    {
+        const bool isKeyframe = in.readU32() != 0;
+        const uint32_t count = in.readU32();
+        const uint32_t actionsCount = in.readU32();
+
+        // Frames use the baked arrays as they are
+        const uint32_t* states = in.readArray<uint32_t>(count);
+        const uint32_t* slots = isKeyframe ? nullptr : in.readArray<uint32_t>(count);
+
+        GAFAnimationFrame* frame = arena.create<GAFAnimationFrame>(isKeyframe, states, slots, count);
+
+        for (uint32_t actionIdx = 0; actionIdx < actionsCount; ++actionIdx)
+        {
+            GAFActionType type = static_cast<GAFActionType>(in.readU32());
+
+            std::string scope;
+            in.readString(&scope);
+
+            ActionParams_t params(in.readU32());
+            for (std::string& param : params)
+            {
+                in.readString(&param);
+            }
+
+            GAFTimelineAction action;
+            action.setAction(type, params, scope);
+            frame->pushTimelineAction(action);
+        }
+
+        timeline->pushAnimationFrame(frame);
+    }
+
+    timeline->endLoading();
+
+    return true;
+}
+
+bool GAFBakedAsset::write(const std::string& filename, const GAFAsset* asset, uint32_t sourceHash, unsigned long sourceLength)
+{
+    std::vector<const GAFTimeline*> timelines;
+
+    const Timelines_t& assetTimelines = asset->getTimelines();
+    for (Timelines_t::const_iterator i = assetTimelines.begin(), e = assetTimelines.end(); i != e; ++i)
+    {
+        timelines.push_back(i->second);
+    }
+
+    std::sort(timelines.begin(), timelines.end(), [](const GAFTimeline* a, const GAFTimeline* b) { return a->getId() < b->getId(); });
+
+    BakedWriter out;
+
+    BakedHeader header = { BakedMagic, BakedVersion, sourceHash, static_cast<uint32_t>(sourceLength), 0, static_cast<uint32_t>(timelines.size()) };
+    out.write(&header, sizeof(BakedHeader));
+
+    const size_t entriesPosition = out.size();
+    for (const GAFTimeline* timeline : timelines)
+    {
+        TimelineEntry entry = { timeline->getId(), 0 };
+        out.write(&entry, sizeof(TimelineEntry));
+    }
+
+    for (size_t i = 0, e = timelines.size(); i < e; ++i)
+    {
+        out.setU32(entriesPosition + i * sizeof(TimelineEntry) + offsetof(TimelineEntry, offset), static_cast<uint32_t>(out.size()));
+        writeTimeline(out, timelines[i]);
+    }
+
+    out.setU32(offsetof(BakedHeader, dataHash), XXH32(out.data() + sizeof(BakedHeader), out.size() - sizeof(BakedHeader), 0));
+
+    // Data is written next to the target and renamed, a partially written file is never opened.
+    // Assets loaded at once on several threads write their own temporary files
+    static std::atomic<uint32_t> s_tempFilesCount(0);
+
+    std::ostringstream tempName;
+    tempName << filename << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << "." << s_tempFilesCount++ << ".tmp";
+    const std::string tempFilename = tempName.str();
+
+    bool isWritten = false;
+
+    FILE* fp = fopen(tempFilename.c_str(), "wb");
+    if (fp)
+    {
+        isWritten = fwrite(out.data(), 1, out.size(), fp) == out.size();
+        isWritten = (fclose(fp) == 0) && isWritten;
+    }
+
+    if (isWritten)
+    {
+        remove(filename.c_str());
+        isWritten = rename(tempFilename.c_str(), filename.c_str()) == 0;
+    }
+
+    if (!isWritten)
+    {
+        CCLOGERROR("Cannot write baked GAF data to %s", filename.c_str());
+        remove(tempFilename.c_str());
+    }
+
+    return isWritten;
+}
+
+uint32_t GAFBakedAsset::hashSource(const unsigned char* data, unsigned long length)
+{
+    return XXH32(data, length, 0);
+}
+
+NS_GAF_END
\ No newline at end of file
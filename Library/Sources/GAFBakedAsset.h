@@ -0,0 +1,48 @@
+#pragma once
+
+#include "GAFFile.h"
+
+NS_GAF_BEGIN
+
+class GAFAsset;
+class GAFTimeline;
+class GAFArena;
+
+/// Animation frames and object states of all timelines of an asset stored as a flat versioned blob.
+/// The blob has no pointers, only offsets from its beginning, so it is used right from the mapped file:
+/// restored frames refer to the state arrays inside of it. Baked data is valid only for the source
+/// data it was made from, this is checked by the source hash when it is opened.
+class GAFBakedAsset
+{
+private:
+    struct TimelineEntry
+    {
+        uint32_t            id;
+        uint32_t            offset;
+    };
+
+    GAFFile                 m_file;
+    const TimelineEntry*    m_timelines;
+    uint32_t                m_timelinesCount;
+
+    const TimelineEntry*    _findTimeline(uint32_t id) const;
+
+public:
+    GAFBakedAsset();
+    ~GAFBakedAsset();
+
+    /// Opens baked data. Fails if it is damaged, has another version or was made from another source
+    bool                    open(const std::string& filename, uint32_t sourceHash, unsigned long sourceLength);
+
+    bool                    hasTimeline(uint32_t id) const;
+    /// Fills object states and animation frames of a timeline that has no frames yet.
+    /// Frames are allocated from the arena and refer to the baked data, it must outlive them
+    bool                    restoreTimeline(GAFTimeline* timeline, GAFArena& arena) const;
+
+    /// Serializes frames and states of all loaded timelines of the asset
+    static bool             write(const std::string& filename, const GAFAsset* asset, uint32_t sourceHash, unsigned long sourceLength);
+
+    static uint32_t         hashSource(const unsigned char* data, unsigned long length);
+};
+
+NS_GAF_END
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "GAFPrecompiled.h"
+#include "GAFCompressedTexture.h"
+
+NS_GAF_BEGIN
+
+// Not every GL header has them
+static const uint32_t GAF_COMPRESSED_RGBA_ASTC_4x4 = 0x93B0;
+static const uint32_t GAF_COMPRESSED_RGBA_ASTC_12x12 = 0x93BD;
+static const uint32_t GAF_COMPRESSED_RGBA8_ETC2_EAC = 0x9278;
+static const uint32_t GAF_COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3;
+static const uint32_t GAF_COMPRESSED_RGBA_PVRTC_4BPPV1 = 0x8C02;
+static const uint32_t GAF_ATC_RGBA_INTERPOLATED_ALPHA = 0x87EE;
+
+struct VariantFormat
+{
+    const char* tag;
+    uint32_t    internalFormat;
+};
+
+// In the order of preference, formats with alpha only
+static const VariantFormat s_variantFormats[] =
+{
+    { "astc", GAF_COMPRESSED_RGBA_ASTC_4x4 },
+    { "etc2", GAF_COMPRESSED_RGBA8_ETC2_EAC },
+    { "dxt5", GAF_COMPRESSED_RGBA_S3TC_DXT5 },
+    { "pvrtc", GAF_COMPRESSED_RGBA_PVRTC_4BPPV1 },
+    { "atc", GAF_ATC_RGBA_INTERPOLATED_ALPHA },
+};
+
+GAFCompressedTexture::Formats_t GAFCompressedTexture::s_supportedFormats;
+bool GAFCompressedTexture::s_isCapabilitiesQueried = false;
+
+GAFCompressedTexture::GAFCompressedTexture()
+: m_dataSize(0)
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+, m_rendererRecreatedListener(nullptr)
+#endif
+{
+}
+
+GAFCompressedTexture::~GAFCompressedTexture()
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    if (m_rendererRecreatedListener)
+    {
+        cocos2d::Director::getInstance()->getEventDispatcher()->removeEventListener(m_rendererRecreatedListener);
+    }
+#endif
+}
+
+bool GAFCompressedTexture::initWithKTXImage(const GAFKTXImage& image)
+{
+    if (!isFormatSupported(image.getInternalFormat()))
+    {
+        CCLOGERROR("Compressed texture format 0x%X is not supported by the GPU", image.getInternalFormat());
+        return false;
+    }
+
+    if (!_upload(image))
+    {
+        return false;
+    }
+
+    m_dataSize = image.getImageSize();
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    m_image = image;
+
+#if COCOS2D_VERSION < 0x00030200
+    const std::string eventName = EVENT_COME_TO_FOREGROUND;
+#else
+    const std::string eventName = EVENT_RENDERER_RECREATED;
+#endif
+    m_rendererRecreatedListener = cocos2d::EventListenerCustom::create(eventName, [this](cocos2d::EventCustom*)
+    {
+        // The name has died with the old context
+        _name = 0;
+        _upload(m_image);
+    });
+    cocos2d::Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(m_rendererRecreatedListener, -1);
+#endif
+
+    return true;
+}
+
+bool GAFCompressedTexture::_upload(const GAFKTXImage& image)
+{
+    const GAFKTXImage::Levels_t& levels = image.getLevels();
+
+    // Errors of earlier calls are not ours
+    glGetError();
+
+    GLuint name = 0;
+    glGenTextures(1, &name);
+    cocos2d::GL::bindTexture2D(name);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels.size() > 1 ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    uint32_t width = image.getWidth();
+    uint32_t height = image.getHeight();
+
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), image.getInternalFormat(), width, height, 0,
+            static_cast<GLsizei>(levels[i].size), image.getData() + levels[i].offset);
+
+        width = std::max<uint32_t>(width >> 1, 1);
+        height = std::max<uint32_t>(height >> 1, 1);
+    }
+
+    if (glGetError() != GL_NO_ERROR)
+    {
+        CCLOGERROR("Compressed texture upload failed");
+        cocos2d::GL::deleteTexture(name);
+        return false;
+    }
+
+    _name = name;
+    _pixelsWide = image.getWidth();
+    _pixelsHigh = image.getHeight();
+    _contentSize = cocos2d::Size(static_cast<float>(_pixelsWide), static_cast<float>(_pixelsHigh));
+    _maxS = 1.f;
+    _maxT = 1.f;
+    _hasMipmaps = levels.size() > 1;
+    _hasPremultipliedAlpha = true;
+    // cocos2d has no ETC2 and ASTC formats, this one is the closest for code that asks, getDataSize is exact
+    _pixelFormat = cocos2d::Texture2D::PixelFormat::RGBA8888;
+
+    setGLProgram(cocos2d::ShaderCache::getInstance()->getGLProgram(cocos2d::GLProgram::SHADER_NAME_POSITION_TEXTURE));
+
+    return true;
+}
+
+size_t GAFCompressedTexture::getDataSize() const
+{
+    return m_dataSize;
+}
+
+void GAFCompressedTexture::queryCapabilities()
+{
+    s_supportedFormats.clear();
+
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+
+    if (count > 0)
+    {
+        std::vector<GLint> formats(count);
+        glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+        s_supportedFormats.insert(formats.begin(), formats.end());
+    }
+
+    // Some drivers list only a part of the formats they have extensions for
+    cocos2d::Configuration* configuration = cocos2d::Configuration::getInstance();
+
+    if (configuration->checkForGLExtension("GL_KHR_texture_compression_astc_ldr"))
+    {
+        for (uint32_t format = GAF_COMPRESSED_RGBA_ASTC_4x4; format <= GAF_COMPRESSED_RGBA_ASTC_12x12; ++format)
+        {
+            s_supportedFormats.insert(format);
+        }
+    }
+
+    if (configuration->supportsS3TC())
+    {
+        s_supportedFormats.insert(GAF_COMPRESSED_RGBA_S3TC_DXT5);
+    }
+
+    if (configuration->supportsPVRTC())
+    {
+        s_supportedFormats.insert(GAF_COMPRESSED_RGBA_PVRTC_4BPPV1);
+    }
+
+    if (configuration->supportsATITC())
+    {
+        s_supportedFormats.insert(GAF_ATC_RGBA_INTERPOLATED_ALPHA);
+    }
+
+    s_isCapabilitiesQueried = true;
+}
+
+const GAFCompressedTexture::Formats_t& GAFCompressedTexture::getSupportedFormats()
+{
+    if (!s_isCapabilitiesQueried)
+    {
+        queryCapabilities();
+    }
+
+    return s_supportedFormats;
+}
+
+bool GAFCompressedTexture::isFormatSupported(uint32_t internalFormat)
+{
+    return getSupportedFormats().count(internalFormat) != 0;
+}
+
+std::string GAFCompressedTexture::findVariant(const std::string& path, cocos2d::ZipFile* bundle /*= nullptr*/)
+{
+    const size_t dot = path.rfind('.');
+    const size_t slash = path.find_last_of("/\\");
+    const std::string base = (dot != std::string::npos && (slash == std::string::npos || dot > slash)) ? path.substr(0, dot) : path;
+
+    cocos2d::FileUtils* fileUtils = cocos2d::FileUtils::getInstance();
+
+    for (size_t i = 0; i < sizeof(s_variantFormats) / sizeof(s_variantFormats[0]); ++i)
+    {
+        if (!isFormatSupported(s_variantFormats[i].internalFormat))
+        {
+            continue;
+        }
+
+        const std::string variant = base + "." + s_variantFormats[i].tag + ".ktx";
+
+        if (bundle ? bundle->fileExists(variant) : fileUtils->isFileExist(variant))
+        {
+            return variant;
+        }
+    }
+
+    return std::string();
+}
+
+NS_GAF_END
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "GAFKTXImage.h"
+
+#include <set>
+
+NS_GAF_BEGIN
+
+/// Texture made of a compressed KTX image as is, so formats cocos2d::Texture2D does not know (ETC2, ASTC)
+/// are used as well as the ones it does.
+/// Compressed variants of atlases are looked up next to their images as "name.<format>.ktx", see findVariant.
+/// Their colors are expected to be premultiplied by alpha already, the same as GAF renders decoded images
+class GAFCompressedTexture : public cocos2d::Texture2D
+{
+public:
+    typedef std::set<uint32_t> Formats_t;
+
+private:
+    size_t          m_dataSize;
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    GAFKTXImage     m_image; // Uploaded again when the GL context is recreated
+    cocos2d::EventListenerCustom* m_rendererRecreatedListener;
+#endif
+
+    static Formats_t s_supportedFormats;
+    static bool     s_isCapabilitiesQueried;
+
+    bool            _upload(const GAFKTXImage& image);
+
+public:
+    GAFCompressedTexture();
+    ~GAFCompressedTexture();
+
+    /// @returns false if the GPU does not support the format of the image or uploading failed
+    bool            initWithKTXImage(const GAFKTXImage& image);
+
+    /// Bytes of all mipmap levels on the GPU
+    size_t          getDataSize() const;
+
+    /// Asks GL for the compressed formats the GPU supports. Done by the first call of any method below
+    /// unless called earlier, has to happen on the thread that owns the GL context
+    static void     queryCapabilities();
+    static const Formats_t& getSupportedFormats();
+    static bool     isFormatSupported(uint32_t internalFormat);
+
+    /// Finds a compressed variant of the image in a format the GPU supports: "atlas.astc.ktx" for "atlas.png".
+    /// ASTC is preferred, then ETC2, DXT5, PVRTC and ATC. Formats without alpha are not looked for
+    /// @returns path of the variant or empty string if there is none
+    static std::string findVariant(const std::string& path, cocos2d::ZipFile* bundle = nullptr);
+};
+
+NS_GAF_END
\ No newline at end of file
@@ -6,6 +6,7 @@ NS_GAF_BEGIN
 
 class GAFSprite;
 class GAFObject;
+class GAFAsset;
 
 typedef std::function<void(GAFObject* object, const std::string& sequenceName)>    GAFSequenceDelegate_t;
 typedef std::function<void(GAFObject* obj)>                                        GAFAnimationFinishedPlayDelegate_t;
@@ -14,5 +15,8 @@ typedef std::function<std::string(const std::string&)>
 typedef std::function<void(GAFObject* obj, uint32_t frame)>                        GAFFramePlayedDelegate_t;
 typedef std::function<void(GAFObject* object, const GAFSprite * subobject)>        GAFObjectControlDelegate_t;
 typedef std::function<void(GAFSoundInfo* sound, int32_t repeat, GAFSoundInfo::SyncEvent syncEvent)> GAFSoundDelegate_t;
+typedef std::function<void(GAFAsset* asset)>                                       GAFAssetLoadedDelegate_t;
+typedef std::function<void(float progress)>                                        GAFAssetLoadProgressDelegate_t;
+typedef std::function<bool(size_t loaded, size_t total)>                           GAFImageLoadedDelegate_t; // return false to abort loading
 
 NS_GAF_END
\ No newline at end of file
@@ -8,6 +8,13 @@
     #include <zlib.h>
 #endif
 
+#if GAF_ENABLE_FILE_MAPPING
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 NS_GAF_BEGIN
 
 void GAFFile::_readHeaderBegin(GAFHeader& out)
@@ -18,7 +25,10 @@ void GAFFile::_readHeaderBegin(GAFHeader& out)
 }
 
 GAFFile::GAFFile() : 
-m_data(nullptr)
+m_data(nullptr),
+m_dataPosition(0),
+m_dataLen(0),
+m_dataOwnership(DataOwnership::None)
 {
 
 }
@@ -28,108 +38,86 @@ GAFFile::~GAFFile()
     close();
 }
 
-unsigned char GAFFile::read1Byte()
-{
-    unsigned char retval = 0;
-
-    readBytes(&retval, sizeof(unsigned char));
-
-    return retval;
-}
-
-unsigned short GAFFile::read2Bytes()
-{
-    unsigned short retval = 0;
-
-    readBytes(&retval, sizeof(unsigned short));
-
-    return retval;
-}
-
-unsigned int GAFFile::read4Bytes()
+bool GAFFile::isEOF() const
 {
-    unsigned int retval = 0;
-
-    readBytes(&retval, sizeof(unsigned int));
-
-    return retval;
+    // Actually the data position should never be greater than the data len
+    // But this is better safe
+    return m_dataPosition >= m_dataLen;
 }
 
-unsigned long long GAFFile::read8Bytes()
+size_t GAFFile::readString(std::string* str)
 {
-    unsigned long long retval = 0;
+    const char* data = nullptr;
+    unsigned short len = readStringInplace(&data);
 
-    readBytes(&retval, sizeof(unsigned long long));
+    str->assign(data, len);
 
-    return retval;
+    return str->length() + sizeof(unsigned short);
 }
 
-float GAFFile::readFloat()
+void GAFFile::readBytes(void* dst, unsigned int len)
 {
-    float retval = 0;
-
-    readBytes(&retval, sizeof(float));
+    assert(dst && m_data);
+    assert(m_dataPosition + len <= m_dataLen);
 
-    return retval;
+    memcpy(dst, m_data + m_dataPosition, len);
+    m_dataPosition += len;
 }
 
-double GAFFile::readDouble()
+const unsigned char* GAFFile::readBytesInplace(unsigned int len)
 {
-    double retval = 0;
+    assert(m_data);
+    assert(m_dataPosition + len <= m_dataLen);
 
-    readBytes(&retval, sizeof(double));
+    const unsigned char* retval = m_data + m_dataPosition;
+    m_dataPosition += len;
 
     return retval;
 }
 
-bool GAFFile::isEOF() const
+unsigned short GAFFile::readStringInplace(const char** dst)
 {
-    // Actually the data position should never be greater than the data len
-    // But this is better safe
-    return m_dataPosition >= m_dataLen;
-}
-
-size_t GAFFile::readString(std::string* str)
-{
-    assert(m_dataPosition + sizeof(short) <= m_dataLen);
+    assert(dst);
 
     unsigned short len = read2Bytes();
 
-    assert(m_dataPosition + len <= m_dataLen);
-
-    char* data = new char[len];
-    readBytes(data, len); // WARN. Possible optimization here. We are able to read from m_data directly
-
-    str->assign(data, len);
-
-    delete[] data;
+    *dst = reinterpret_cast<const char*>(readBytesInplace(len));
 
-    return str->length() + sizeof(unsigned short);
+    return len;
 }
 
-void GAFFile::readBytes(void* dst, unsigned int len)
+void GAFFile::close()
 {
-    assert(dst && m_data);
-    assert(m_dataPosition + len <= m_dataLen);
-
-    memcpy(dst, m_data + m_dataPosition, len);
-    m_dataPosition += len;
+    _releaseData();
+    m_dataLen = 0;
+    m_dataPosition = 0;
 }
 
-void GAFFile::close()
+void GAFFile::_releaseData()
 {
-    delete[] m_data;
+    if (m_dataOwnership == DataOwnership::Heap)
+    {
+        free(m_data);
+    }
+#if GAF_ENABLE_FILE_MAPPING
+    else if (m_dataOwnership == DataOwnership::Mapped)
+    {
+        munmap(m_data, m_dataLen);
+    }
+#endif
+
     m_data = nullptr;
-    m_dataLen = 0;
-    m_dataPosition = 0;
+    m_dataOwnership = DataOwnership::None;
 }
 
 bool GAFFile::open(const unsigned char* data, size_t len)
 {
     close();
 
+    // Data is malloc'ed by the caller (e.g. ZipFile::getFileData) and is owned by the file from now on
     m_data = const_cast<unsigned char*>(data);
     m_dataLen = len;
+    m_dataOwnership = DataOwnership::Heap;
 
     if (m_data)
     {
@@ -139,13 +127,24 @@ bool GAFFile::open(const unsigned char* data, size_t len)
     return false;
 }
 
-bool GAFFile::open(const std::string& filePath, const char* openMode)
+bool GAFFile::openView(const GAFFile* source)
 {
     close();
 
-    m_data = _getData(filePath, openMode, m_dataLen);
+    assert(source && source->isOpened());
 
-    if (m_data)
+    m_data = source->m_data;
+    m_dataLen = source->m_dataLen;
+    m_dataPosition = source->m_dataPosition;
+    m_dataOwnership = DataOwnership::None;
+    m_header = source->m_header;
+
+    return m_data != nullptr;
+}
+
+bool GAFFile::open(const std::string& filePath, const char* openMode)
+{
+    if (_openData(filePath, openMode))
     {
         return _processOpen();
     }
@@ -153,6 +152,30 @@ bool GAFFile::open(const std::string& filePath, const char* openMode)
     return false;
 }
 
+bool GAFFile::openRaw(const std::string& filePath)
+{
+    return _openData(filePath, "rb");
+}
+
+bool GAFFile::_openData(const std::string& filePath, const char* openMode)
+{
+    close();
+
+    m_data = _mapData(filePath, m_dataLen);
+
+    if (m_data)
+    {
+        m_dataOwnership = DataOwnership::Mapped;
+    }
+    else
+    {
+        m_data = _getData(filePath, openMode, m_dataLen);
+        m_dataOwnership = DataOwnership::Heap;
+    }
+
+    return m_data != nullptr;
+}
+
 bool GAFFile::isOpened() const
 {
     return m_data != NULL;
@@ -173,6 +196,19 @@ unsigned int GAFFile::getPosition() const
     return m_dataPosition;
 }
 
+unsigned long GAFFile::getDataLength() const
+{
+    return m_dataLen;
+}
+
+const unsigned char* GAFFile::getDataAt(unsigned int position) const
+{
+    assert(m_data);
+    assert(position <= m_dataLen);
+
+    return m_data + position;
+}
+
 void GAFFile::rewind(unsigned int newPos)
 {
     m_dataPosition = newPos;
@@ -221,6 +257,124 @@ unsigned char* GAFFile::_getData(const std::string& filename, const char* openMo
     return ret;
 }
 
+unsigned char* GAFFile::_mapData(const std::string& filename, unsigned long& outLen)
+{
+    assert(!(filename.empty()));
+
+    outLen = 0;
+
+#if GAF_ENABLE_FILE_MAPPING
+    std::string fullPath = cocos2d::FileUtils::getInstance()->fullPathForFilename(filename);
+
+    int fd = ::open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    unsigned char* ret = nullptr;
+    struct stat st;
+
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            // Tags are parsed front to back, let the kernel read ahead aggressively
+            madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+
+            ret = static_cast<unsigned char*>(mapping);
+            outLen = st.st_size;
+        }
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+
+    return ret;
+#else
+    (void)filename;
+    return nullptr;
+#endif
+}
+
+#if USE_ZLIB
+unsigned char* GAFFile::_inflateData(const unsigned char* src, unsigned long srcLen, unsigned long dstLen)
+{
+    // Input is fed in chunks so the consumed part of a mapped file can be dropped
+    // from memory while the rest is still being inflated. Output goes straight
+    // to the final buffer, no intermediate copies are made.
+    static const unsigned long InflateChunkSize = 256 * 1024;
+
+    unsigned char* dst = static_cast<unsigned char*>(malloc(dstLen));
+    if (!dst)
+    {
+        return nullptr;
+    }
+
+    z_stream zs;
+    memset(&zs, 0, sizeof(z_stream));
+
+    if (inflateInit(&zs) != Z_OK)
+    {
+        free(dst);
+        return nullptr;
+    }
+
+    zs.next_out = dst;
+    zs.avail_out = static_cast<uInt>(dstLen);
+
+    const unsigned char* srcEnd = src + srcLen;
+    const unsigned char* chunk = src;
+#if GAF_ENABLE_FILE_MAPPING
+    const unsigned char* released = m_data;
+    const uintptr_t pageMask = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)) - 1;
+#endif
+
+    int retStatus = Z_OK;
+
+    while (retStatus == Z_OK && chunk < srcEnd)
+    {
+        unsigned long chunkLen = std::min<unsigned long>(InflateChunkSize, srcEnd - chunk);
+
+        zs.next_in = const_cast<Bytef*>(chunk);
+        zs.avail_in = static_cast<uInt>(chunkLen);
+
+        retStatus = inflate(&zs, chunkLen < InflateChunkSize ? Z_FINISH : Z_NO_FLUSH);
+
+        if (retStatus == Z_BUF_ERROR && zs.avail_in == 0)
+        {
+            retStatus = Z_OK; // Needs more input
+        }
+
+        chunk = zs.next_in;
+
+#if GAF_ENABLE_FILE_MAPPING
+        if (m_dataOwnership == DataOwnership::Mapped)
+        {
+            const unsigned char* consumed = reinterpret_cast<const unsigned char*>(reinterpret_cast<uintptr_t>(chunk) & ~pageMask);
+            if (consumed > released)
+            {
+                madvise(const_cast<unsigned char*>(released), consumed - released, MADV_DONTNEED);
+                released = consumed;
+            }
+        }
+#endif
+    }
+
+    inflateEnd(&zs);
+
+    if (retStatus != Z_STREAM_END || zs.total_out != dstLen)
+    {
+        CCLOGERROR("Cannot inflate GAF data. Status: %d, inflated [%lu] of [%lu] bytes", retStatus, static_cast<unsigned long>(zs.total_out), dstLen);
+        free(dst);
+        return nullptr;
+    }
+
+    return dst;
+}
+#endif
+
 bool GAFFile::_processOpen()
 {
     _readHeaderBegin(m_header);
@@ -237,27 +391,19 @@ bool GAFFile::_processOpen()
     else if (m_header.compression == GAFHeader::CompressedZip)
     {
 #if USE_ZLIB
-        unsigned long uncompressedSize = m_header.fileLenght;
-        char* uncompressedBuffer = new char[uncompressedSize];
+        unsigned char* uncompressedBuffer = _inflateData(m_data + m_dataPosition, m_dataLen - m_dataPosition, m_header.fileLenght);
 
-        int retStatus = uncompress((Bytef*)uncompressedBuffer, &uncompressedSize, (Bytef*)(m_data + m_dataPosition), m_dataLen - m_dataPosition); // Decompress rest
-
-        if (retStatus != Z_OK)
+        if (!uncompressedBuffer)
         {
             return false;
         }
 
-        assert("Paranoid mode" && uncompressedSize == m_header.fileLenght);
-
-        delete[] m_data;
+        _releaseData();
 
-        m_data = new unsigned char[uncompressedSize];
-
-        memcpy(m_data, uncompressedBuffer, uncompressedSize);
-        m_dataLen = uncompressedSize;
+        m_data = uncompressedBuffer;
+        m_dataOwnership = DataOwnership::Heap;
+        m_dataLen = m_header.fileLenght;
         m_dataPosition = 0;
-
-        delete[] uncompressedBuffer;
 #else
         assert("ZLIB is disabled" && false);
 #endif
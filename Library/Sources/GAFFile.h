@@ -7,13 +7,28 @@ NS_GAF_BEGIN
 class GAFFile
 {
 private:
+    enum class DataOwnership : uint8_t
+    {
+        None = 0,   // Buffer belongs to somebody else
+        Heap,       // Buffer is allocated with malloc
+        Mapped      // Buffer is a read-only mapping of the file
+    };
+
     unsigned char*        m_data;
     unsigned int          m_dataPosition;
     unsigned long         m_dataLen;
+    DataOwnership         m_dataOwnership;
     GAFHeader             m_header;
 private:
     unsigned char*       _getData(const std::string& filename, const char* openMode, unsigned long& outLen);
+    unsigned char*       _mapData(const std::string& filename, unsigned long& outLen);
+    bool                 _openData(const std::string& filename, const char* openMode);
+    void                 _releaseData();
+    unsigned char*       _inflateData(const unsigned char* src, unsigned long srcLen, unsigned long dstLen);
     bool                 _processOpen();
+
+    template <typename T>
+    inline T             _readValue();
 protected:
     void                 _readHeaderBegin(GAFHeader&);
 public:
@@ -32,11 +47,19 @@ public:
     size_t               readString(std::string* dst); // function reads lenght prefixed string
     void                 readBytes(void* dst, unsigned int len);
 
+    // Zero-copy readers. Returned pointers stay valid until the file is closed
+    const unsigned char* readBytesInplace(unsigned int len);
+    unsigned short       readStringInplace(const char** dst); // returns string length, string is not null terminated
+
     void                 close();
 
     // TODO: Provide error codes
     bool                 open(const std::string& filename, const char* openMode);
     bool                 open(const unsigned char* data, size_t len);
+    /// Opens a file as is, without reading GAF header. Used for data that is not in GAF format
+    bool                 openRaw(const std::string& filename);
+    /// Shares opened data of another file. The source must stay opened while the view is used
+    bool                 openView(const GAFFile* source);
 
     bool                 isOpened() const;
 
@@ -45,6 +68,55 @@ public:
 
     unsigned int         getPosition() const;
     void                 rewind(unsigned int newPos);
+    unsigned long        getDataLength() const;
+
+    /// Pointer to the opened data at the given position, stays valid until the file is closed
+    const unsigned char* getDataAt(unsigned int position) const;
 };
 
+// Primitive reads are on the hot path of every tag reader, keep them inlined.
+// Bounds are validated once per tag by GAFStream::openTag
+template <typename T>
+inline T GAFFile::_readValue()
+{
+    assert(m_data);
+    assert(m_dataPosition + sizeof(T) <= m_dataLen);
+
+    T retval;
+    memcpy(&retval, m_data + m_dataPosition, sizeof(T));
+    m_dataPosition += sizeof(T);
+
+    return retval;
+}
+
+inline unsigned char GAFFile::read1Byte()
+{
+    return _readValue<unsigned char>();
+}
+
+inline unsigned short GAFFile::read2Bytes()
+{
+    return _readValue<unsigned short>();
+}
+
+inline unsigned int GAFFile::read4Bytes()
+{
+    return _readValue<unsigned int>();
+}
+
+inline unsigned long long GAFFile::read8Bytes()
+{
+    return _readValue<unsigned long long>();
+}
+
+inline float GAFFile::readFloat()
+{
+    return _readValue<float>();
+}
+
+inline double GAFFile::readDouble()
+{
+    return _readValue<double>();
+}
+
 NS_GAF_END
\ No newline at end of file
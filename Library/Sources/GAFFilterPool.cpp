@@ -0,0 +1,47 @@
+#include "GAFPrecompiled.h"
+#include "GAFFilterPool.h"
+
+NS_GAF_BEGIN
+
+GAFFilterPool::GAFFilterPool()
+: m_filtersCount(0)
+, m_internedHits(0)
+{
+}
+
+GAFFilterData* GAFFilterPool::intern(const unsigned char* record, unsigned int size, GAFFilterData* filter)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::pair<Filters_t::iterator, bool> it = m_filters.insert(std::make_pair(std::string(reinterpret_cast<const char*>(record), size), filter));
+    if (it.second)
+    {
+        ++m_filtersCount;
+    }
+    else
+    {
+        ++m_internedHits;
+    }
+
+    return it.first->second;
+}
+
+void GAFFilterPool::endLoading()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Filters_t().swap(m_filters);
+}
+
+size_t GAFFilterPool::getFiltersCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_filtersCount;
+}
+
+size_t GAFFilterPool::getInternedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_internedHits;
+}
+
+NS_GAF_END
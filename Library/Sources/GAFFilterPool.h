@@ -0,0 +1,40 @@
+#pragma once
+
+#include "GAFMacros.h"
+
+#include <mutex>
+#include <unordered_map>
+
+NS_GAF_BEGIN
+
+class GAFFilterData;
+
+/// Filters of all timelines of an asset loaded from identical records, i.e. of the same type and parameters,
+/// are kept as one object. Thread safe, timelines loaded concurrently share the pool of their asset
+class GAFFilterPool
+{
+private:
+    typedef std::unordered_map<std::string, GAFFilterData*> Filters_t; // Filter record -> filter
+
+    Filters_t               m_filters; // Load time only
+    size_t                  m_filtersCount;
+    size_t                  m_internedHits;
+    mutable std::mutex      m_mutex;
+
+public:
+    GAFFilterPool();
+
+    /// Pools the filter loaded from the record unless a filter of an identical record is pooled already.
+    /// @returns the pooled filter, the given one is not used by the caller if it differs
+    GAFFilterData*          intern(const unsigned char* record, unsigned int size, GAFFilterData* filter);
+
+    /// Drops the lookup table once the asset is loaded, pooled filters stay in the asset arena
+    void                    endLoading();
+
+    /// Number of distinct filters
+    size_t                  getFiltersCount() const;
+    /// Number of loaded filters that were replaced with already pooled identical ones
+    size_t                  getInternedCount() const;
+};
+
+NS_GAF_END
@@ -0,0 +1,174 @@
+#include "GAFPrecompiled.h"
+#include "GAFKTXImage.h"
+
+NS_GAF_BEGIN
+
+static const unsigned char s_identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+static const uint32_t s_endianness = 0x04030201;
+static const uint32_t s_swappedEndianness = 0x01020304;
+
+static const size_t s_headerSize = sizeof(s_identifier) + 13 * sizeof(uint32_t);
+
+enum KTXHeaderField
+{
+    KTX_Endianness = 0,
+    KTX_GLType,
+    KTX_GLTypeSize,
+    KTX_GLFormat,
+    KTX_GLInternalFormat,
+    KTX_GLBaseInternalFormat,
+    KTX_PixelWidth,
+    KTX_PixelHeight,
+    KTX_PixelDepth,
+    KTX_NumberOfArrayElements,
+    KTX_NumberOfFaces,
+    KTX_NumberOfMipmapLevels,
+    KTX_BytesOfKeyValueData,
+
+    KTX_FieldsCount
+};
+
+static uint32_t readU32(const unsigned char* data, bool isSwapped)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+
+    if (isSwapped)
+    {
+        value = (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+    }
+
+    return value;
+}
+
+GAFKTXImage::GAFKTXImage()
+: m_internalFormat(0)
+, m_width(0)
+, m_height(0)
+{
+}
+
+bool GAFKTXImage::initWithFile(const std::string& path)
+{
+    return initWithData(cocos2d::FileUtils::getInstance()->getDataFromFile(path));
+}
+
+bool GAFKTXImage::initWithData(const cocos2d::Data& data)
+{
+    m_levels.clear();
+
+    const unsigned char* bytes = data.getBytes();
+    const size_t size = data.isNull() ? 0 : static_cast<size_t>(data.getSize());
+
+    if (size < s_headerSize || memcmp(bytes, s_identifier, sizeof(s_identifier)) != 0)
+    {
+        return false;
+    }
+
+    // Files written on a machine of the other byte order are swapped, image data of compressed formats is not
+    const unsigned char* fieldsData = bytes + sizeof(s_identifier);
+    const uint32_t endianness = readU32(fieldsData, false);
+    if (endianness != s_endianness && endianness != s_swappedEndianness)
+    {
+        return false;
+    }
+
+    const bool isSwapped = endianness == s_swappedEndianness;
+
+    uint32_t fields[KTX_FieldsCount];
+    for (int i = 0; i < KTX_FieldsCount; ++i)
+    {
+        fields[i] = readU32(fieldsData + i * sizeof(uint32_t), isSwapped);
+    }
+
+    // glType and glFormat are zero for compressed textures
+    if (fields[KTX_GLType] != 0 || fields[KTX_GLFormat] != 0)
+    {
+        CCLOGERROR("KTX image is not compressed");
+        return false;
+    }
+
+    if (fields[KTX_PixelWidth] == 0 || fields[KTX_PixelHeight] == 0 || fields[KTX_PixelDepth] > 1
+        || fields[KTX_NumberOfArrayElements] > 0 || fields[KTX_NumberOfFaces] != 1)
+    {
+        CCLOGERROR("KTX image is not a 2D texture");
+        return false;
+    }
+
+    if (fields[KTX_BytesOfKeyValueData] > size - s_headerSize)
+    {
+        return false;
+    }
+
+    size_t position = s_headerSize + fields[KTX_BytesOfKeyValueData];
+    const uint32_t levelsCount = std::max<uint32_t>(fields[KTX_NumberOfMipmapLevels], 1);
+
+    for (uint32_t i = 0; i < levelsCount; ++i)
+    {
+        if (position + sizeof(uint32_t) > size)
+        {
+            m_levels.clear();
+            return false;
+        }
+
+        Level level;
+        level.size = readU32(bytes + position, isSwapped);
+        level.offset = position + sizeof(uint32_t);
+
+        if (level.size == 0 || level.size > size - level.offset)
+        {
+            m_levels.clear();
+            return false;
+        }
+
+        m_levels.push_back(level);
+
+        // Every level is padded to 4 bytes
+        position = level.offset + ((level.size + 3) & ~static_cast<size_t>(3));
+    }
+
+    m_internalFormat = fields[KTX_GLInternalFormat];
+    m_width = fields[KTX_PixelWidth];
+    m_height = fields[KTX_PixelHeight];
+    m_data = data;
+
+    return true;
+}
+
+uint32_t GAFKTXImage::getInternalFormat() const
+{
+    return m_internalFormat;
+}
+
+uint32_t GAFKTXImage::getWidth() const
+{
+    return m_width;
+}
+
+uint32_t GAFKTXImage::getHeight() const
+{
+    return m_height;
+}
+
+const GAFKTXImage::Levels_t& GAFKTXImage::getLevels() const
+{
+    return m_levels;
+}
+
+const unsigned char* GAFKTXImage::getData() const
+{
+    return m_data.getBytes();
+}
+
+size_t GAFKTXImage::getImageSize() const
+{
+    size_t size = 0;
+    for (Levels_t::const_iterator i = m_levels.begin(), e = m_levels.end(); i != e; ++i)
+    {
+        size += i->size;
+    }
+    return size;
+}
+
+NS_GAF_END
\ No newline at end of file
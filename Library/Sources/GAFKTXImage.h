@@ -0,0 +1,46 @@
+#pragma once
+
+#include "GAFMacros.h"
+
+NS_GAF_BEGIN
+
+/// KTX 1.1 container of a compressed image, e.g. ETC2, ASTC, PVRTC or DXT atlas made by a texture tool.
+/// Only the container is parsed here, no GL is needed for it. Cubemaps, arrays and 3D textures are rejected
+class GAFKTXImage
+{
+public:
+    struct Level
+    {
+        size_t      offset; // In getData
+        size_t      size;
+    };
+
+    typedef std::vector<Level> Levels_t;
+
+private:
+    cocos2d::Data   m_data;
+    Levels_t        m_levels;
+
+    uint32_t        m_internalFormat;
+    uint32_t        m_width;
+    uint32_t        m_height;
+
+public:
+    GAFKTXImage();
+
+    bool            initWithFile(const std::string& path);
+    /// @returns false if the data is not a KTX container of a compressed 2D texture or is truncated
+    bool            initWithData(const cocos2d::Data& data);
+
+    /// glInternalFormat of the container, GL_COMPRESSED_* value
+    uint32_t        getInternalFormat() const;
+    uint32_t        getWidth() const;
+    uint32_t        getHeight() const;
+    /// Mipmap levels from the biggest one, there is one at least
+    const Levels_t& getLevels() const;
+    const unsigned char* getData() const;
+    /// Bytes of all mipmap levels
+    size_t          getImageSize() const;
+};
+
+NS_GAF_END
\ No newline at end of file
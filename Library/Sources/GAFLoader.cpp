@@ -6,6 +6,7 @@
 #include "GAFStream.h"
 #include "GAFFile.h"
 #include "GAFTimeline.h"
+#include "GAFBakedAsset.h"
 
 #include "PrimitiveDeserializer.h"
 
@@ -22,6 +23,10 @@
 #include "TagDefineTextField.h"
 #include "TagDefineSounds.h"
 
+#include <atomic>
+#include <memory>
+#include <thread>
+
 NS_GAF_BEGIN
 
 void GAFLoader::_readHeaderEnd(GAFHeader& header)
@@ -80,7 +85,11 @@ void GAFLoader::_registerTagLoadersCommon()
 }
 
 GAFLoader::GAFLoader():
-m_stream(nullptr)
+m_stream(nullptr),
+m_parallelTimelineLoading(true),
+m_hasCustomTagLoaders(false),
+m_scanResourcesOnly(false),
+m_bakedAsset(nullptr)
 {
 }
 
@@ -100,33 +109,303 @@ void GAFLoader::loadTags(GAFStream* in, GAFAsset* asset, GAFTimeline* timeline)
     {
         Tags::Enum tag = in->openTag();
 
-        TagLoaders_t::iterator it = m_tagLoaders.find(tag);
+        _readTag(in, tag, asset, timeline);
+
+        in->closeTag();
 
-        if (it != m_tagLoaders.end())
+        if (tag == Tags::TagEnd)
         {
-            it->second->read(in, asset, timeline);
+            tagEndRead = true;
+            break;
         }
-        else
+    }
+
+    if (!tagEndRead)
+    {
+        //TODO: warning or error here
+    }
+}
+
+bool GAFLoader::_isResourceTag(Tags::Enum tag)
+{
+    switch (tag)
+    {
+    case Tags::TagDefineAtlas:
+    case Tags::TagDefineAtlas2:
+    case Tags::TagDefineAtlas3:
+    case Tags::TagDefineTextFields:
+    case Tags::TagDefineSounds:
+    case Tags::TagDefineTimeline: // Holds resource tags of its own
+        return true;
+    default:
+        return false;
+    }
+}
+
+void GAFLoader::_collectLoadedTimelines(GAFStream* in)
+{
+    typedef std::unordered_map<uint32_t, std::vector<uint32_t>> NestedTimelines_t;
+    NestedTimelines_t nestedTimelines;
+    std::vector<uint32_t> pending;
+
+    // Only headers and object lists of timelines are read, everything else is skipped by its length
+    const unsigned int startPosition = in->getPosition();
+
+    while (!in->isEndOfStream())
+    {
+        Tags::Enum tag = in->openTag();
+
+        if (tag == Tags::TagDefineTimeline)
         {
-            if (tag != Tags::TagEnd)
+            uint32_t id = in->readU32();
+            in->readU32(); // frames count
+
+            cocos2d::Rect aabb;
+            cocos2d::Point pivot;
+            PrimitiveDeserializer::deserialize(in, &aabb);
+            PrimitiveDeserializer::deserialize(in, &pivot);
+
+            if (in->readUByte())
             {
-                CCLOG("No tag parser for %d. Custom loader needed", tag);
+                std::string linkageName;
+                in->readString(&linkageName);
+
+                if (std::find(m_rootTimelines.begin(), m_rootTimelines.end(), linkageName) != m_rootTimelines.end())
+                {
+                    pending.push_back(id);
+                }
+            }
+
+            std::vector<uint32_t>& nested = nestedTimelines[id];
+
+            while (!in->isEndOfStream())
+            {
+                Tags::Enum timelineTag = in->openTag();
+
+                if (timelineTag == Tags::TagDefineAnimationObjects2 || timelineTag == Tags::TagDefineAnimationMasks2)
+                {
+                    unsigned int count = in->readU32();
+                    for (unsigned int i = 0; i < count; ++i)
+                    {
+                        in->readU32(); // object id
+                        uint32_t elementAtlasIdRef = in->readU32();
+
+                        if (static_cast<GAFCharacterType>(in->readU16()) == GAFCharacterType::Timeline)
+                        {
+                            nested.push_back(elementAtlasIdRef);
+                        }
+                    }
+                }
+
+                in->skipTag();
+
+                if (timelineTag == Tags::TagEnd)
+                {
+                    break;
+                }
             }
         }
 
-        in->closeTag();
+        in->skipTag();
 
         if (tag == Tags::TagEnd)
         {
-            tagEndRead = true;
             break;
         }
     }
 
-    if (!tagEndRead)
+    in->getInput()->rewind(startPosition);
+
+    while (!pending.empty())
     {
-        //TODO: warning or error here
+        uint32_t id = pending.back();
+        pending.pop_back();
+
+        if (m_loadedTimelines.insert(id).second)
+        {
+            const std::vector<uint32_t>& nested = nestedTimelines[id];
+            pending.insert(pending.end(), nested.begin(), nested.end());
+        }
+    }
+
+    if (m_loadedTimelines.empty())
+    {
+        CCLOGERROR("None of the requested root timelines is found, all timelines are loaded");
+    }
+}
+
+bool GAFLoader::_isTimelineSkipped(GAFStream* in) const
+{
+    if (m_loadedTimelines.empty())
+    {
+        return false;
+    }
+
+    // Timeline id goes first in the tag
+    const unsigned int position = in->getPosition();
+    const uint32_t id = in->readU32();
+    in->getInput()->rewind(position);
+
+    return m_loadedTimelines.find(id) == m_loadedTimelines.end();
+}
+
+void GAFLoader::_readTag(GAFStream* in, Tags::Enum tag, GAFAsset* asset, GAFTimeline* timeline)
+{
+    if ((m_scanResourcesOnly && !_isResourceTag(tag)) || (tag == Tags::TagDefineTimeline && _isTimelineSkipped(in)))
+    {
+        in->getInput()->rewind(in->getTagExpectedPosition());
+        return;
+    }
+
+    if (m_bakedAsset && timeline && (tag == Tags::TagDefineAnimationFrames || tag == Tags::TagDefineAnimationFrames2)
+        && m_bakedAsset->restoreTimeline(timeline, *in->getArena()))
+    {
+        in->getInput()->rewind(in->getTagExpectedPosition());
+        return;
+    }
+
+    TagLoaders_t::iterator it = m_tagLoaders.find(tag);
+
+    if (it != m_tagLoaders.end())
+    {
+        it->second->read(in, asset, timeline);
+    }
+    else
+    {
+        if (tag != Tags::TagEnd)
+        {
+            CCLOG("No tag parser for %d. Custom loader needed", tag);
+        }
+    }
+}
+
+void GAFLoader::_loadTagsParallel(GAFStream* in, GAFAsset* asset)
+{
+    struct TagRecord
+    {
+        Tags::Enum tag;
+        unsigned int position;
+        unsigned int length;
+    };
+
+    // Every tag carries its length, so the table of contents is built without parsing anything
+    const unsigned int startPosition = in->getPosition();
+
+    std::vector<TagRecord> tags;
+    std::vector<size_t> timelineTags;
+
+    while (!in->isEndOfStream())
+    {
+        unsigned int position = in->getPosition();
+        Tags::Enum tag = in->openTag();
+
+        TagRecord record = { tag, position, in->getTagLenghtOnStackTop() };
+        const bool isSkipped = tag == Tags::TagDefineTimeline && _isTimelineSkipped(in);
+        in->skipTag();
+
+        if (isSkipped)
+        {
+            continue;
+        }
+
+        if (tag == Tags::TagDefineTimeline)
+        {
+            timelineTags.push_back(tags.size());
+        }
+
+        tags.push_back(record);
+
+        if (tag == Tags::TagEnd)
+        {
+            break;
+        }
+    }
+
+    const unsigned int endPosition = in->getPosition();
+    const size_t workersCount = std::min<size_t>(std::thread::hardware_concurrency(), timelineTags.size());
+
+    if (workersCount < 2)
+    {
+        in->getInput()->rewind(startPosition);
+        loadTags(in, asset, nullptr);
+        return;
+    }
+
+    // Biggest timelines go first for better balancing
+    std::stable_sort(timelineTags.begin(), timelineTags.end(), [&tags](size_t a, size_t b) { return tags[a].length > tags[b].length; });
+
+    std::vector<GAFTimeline*> timelines(tags.size(), nullptr);
+    std::atomic<size_t> nextJob(0);
+    GAFFile* source = in->getInput();
+
+    // Arenas are not thread-safe, every worker fills its own one
+    std::vector<std::unique_ptr<GAFArena>> arenas;
+    for (size_t i = 0; i < workersCount; ++i)
+    {
+        arenas.push_back(std::unique_ptr<GAFArena>(new GAFArena()));
+    }
+
+    auto worker = [&](GAFArena* arena)
+    {
+        // Tag loaders keep state between calls, every worker needs its own set
+        GAFLoader loader;
+        loader._registerTagLoadersV4();
+        loader._registerTagLoadersCommon();
+        loader.m_bakedAsset = m_bakedAsset;
+
+        TagDefineTimeline timelineReader(&loader);
+
+        GAFFile view;
+        view.openView(source);
+        GAFStream stream(&view);
+        stream.setArena(arena);
+        stream.setFilterPool(&asset->getFilterPool());
+
+        for (size_t job = nextJob++; job < timelineTags.size(); job = nextJob++)
+        {
+            const size_t idx = timelineTags[job];
+
+            view.rewind(tags[idx].position);
+            stream.openTag();
+            timelines[idx] = timelineReader.readTimeline(&stream, asset, nullptr);
+            stream.closeTag();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workersCount; ++i)
+    {
+        threads.push_back(std::thread(worker, arenas[i].get()));
+    }
+
+    worker(arenas[0].get());
+
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+
+    for (size_t i = 0; i < workersCount; ++i)
+    {
+        asset->getArena().merge(*arenas[i]);
+    }
+
+    // Everything that touches the asset happens here in the file order
+    for (size_t i = 0, e = tags.size(); i < e; ++i)
+    {
+        if (tags[i].tag == Tags::TagDefineTimeline)
+        {
+            TagDefineTimeline::pushTimeline(asset, timelines[i]);
+            continue;
+        }
+
+        in->getInput()->rewind(tags[i].position);
+        Tags::Enum tag = in->openTag();
+        _readTag(in, tag, asset, nullptr);
+        in->closeTag();
     }
+
+    in->getInput()->rewind(endPosition);
 }
 
 bool GAFLoader::loadData(const unsigned char* data, size_t len, GAFAsset* context)
@@ -150,6 +429,8 @@ bool GAFLoader::loadData(const unsigned char* data, size_t len, GAFAsset* contex
 void GAFLoader::_processLoad(GAFFile* file, GAFAsset* context)
 {
     m_stream = new GAFStream(file);
+    m_stream->setArena(&context->getArena());
+    m_stream->setFilterPool(&context->getFilterPool());
 
     GAFHeader& header = m_stream->getInput()->getHeader();
 
@@ -173,7 +454,65 @@ void GAFLoader::_processLoad(GAFFile* file, GAFAsset* context)
 
     context->setHeader(header);
 
-    loadTags(m_stream, context, timeline);
+    m_loadedTimelines.clear();
+    if (header.getMajorVersion() >= 4 && !m_rootTimelines.empty())
+    {
+        _collectLoadedTimelines(m_stream);
+    }
+
+    // Custom tag loaders may read frames in their own way, their results are not baked
+    const std::string bakedPath = m_hasCustomTagLoaders ? std::string() : context->_getBakedCachePath();
+    uint32_t sourceHash = 0;
+    bool isSourceHashed = false;
+
+    // The source is hashed only to validate an existing baked file or to write a new one
+    if (!bakedPath.empty() && cocos2d::FileUtils::getInstance()->isFileExist(bakedPath))
+    {
+        sourceHash = GAFBakedAsset::hashSource(file->getDataAt(0), file->getDataLength());
+        isSourceHashed = true;
+
+        GAFBakedAsset* baked = new GAFBakedAsset();
+        if (baked->open(bakedPath, sourceHash, file->getDataLength()))
+        {
+            delete context->m_bakedAsset;
+            context->m_bakedAsset = baked;
+            m_bakedAsset = baked;
+        }
+        else
+        {
+            delete baked;
+        }
+    }
+
+    if (header.getMajorVersion() >= 4 && m_parallelTimelineLoading && !m_hasCustomTagLoaders && !m_scanResourcesOnly)
+    {
+        _loadTagsParallel(m_stream, context);
+    }
+    else
+    {
+        loadTags(m_stream, context, timeline);
+    }
+
+    // Baked copy of a part of the timelines would stop the rest from being baked
+    if (!bakedPath.empty() && !m_bakedAsset && m_loadedTimelines.empty())
+    {
+        if (!isSourceHashed)
+        {
+            sourceHash = GAFBakedAsset::hashSource(file->getDataAt(0), file->getDataLength());
+        }
+        GAFBakedAsset::write(bakedPath, context, sourceHash, file->getDataLength());
+    }
+
+    for (size_t i = 0; i < m_rootTimelines.size() && !m_loadedTimelines.empty(); ++i)
+    {
+        if (context->setRootTimeline(m_rootTimelines[i]))
+        {
+            break;
+        }
+    }
+
+    m_bakedAsset = nullptr;
+    context->getFilterPool().endLoading();
 
     delete m_stream;
 }
@@ -214,6 +553,22 @@ const GAFHeader& GAFLoader::getHeader() const
 void GAFLoader::registerTagLoader(unsigned int idx, DefinitionTagBase* tagptr)
 {
     m_tagLoaders[static_cast<Tags::Enum>(idx)] = tagptr;
+    m_hasCustomTagLoaders = true;
+}
+
+void GAFLoader::setParallelTimelineLoading(bool value)
+{
+    m_parallelTimelineLoading = value;
+}
+
+void GAFLoader::setScanResourcesOnly(bool value)
+{
+    m_scanResourcesOnly = value;
+}
+
+void GAFLoader::setRootTimelines(const std::vector<std::string>& linkageNames)
+{
+    m_rootTimelines = linkageNames;
 }
 
 NS_GAF_END
\ No newline at end of file
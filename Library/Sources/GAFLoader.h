@@ -2,6 +2,8 @@
 
 #include "TagDefines.h"
 
+#include <unordered_set>
+
 NS_GAF_BEGIN
 
 class GAFAsset;
@@ -11,11 +13,21 @@ class GAFStream;
 class DefinitionTagBase;
 class GAFHeader;
 class GAFFile;
+class GAFBakedAsset;
 
 class GAFLoader
 {
 private:
     GAFStream*           m_stream;
+    bool                 m_parallelTimelineLoading;
+    bool                 m_hasCustomTagLoaders;
+    bool                 m_scanResourcesOnly;
+    const GAFBakedAsset* m_bakedAsset; // Replaces animation frame tags when valid
+
+    typedef std::unordered_set<uint32_t> TimelineIds_t;
+
+    std::vector<std::string> m_rootTimelines;
+    TimelineIds_t        m_loadedTimelines; // Closure of m_rootTimelines, empty when all timelines are loaded
 
     void                 _readHeaderEnd(GAFHeader&);
     void                 _readHeaderEndV4(GAFHeader&);
@@ -24,6 +36,14 @@ private:
     void                 _registerTagLoadersCommon();
     void                 _registerTagLoadersV4();
 
+    static bool          _isResourceTag(Tags::Enum tag);
+
+    void                 _collectLoadedTimelines(GAFStream* in);
+    bool                 _isTimelineSkipped(GAFStream* in) const;
+
+    void                 _readTag(GAFStream* in, Tags::Enum tag, GAFAsset* asset, GAFTimeline* timeline);
+    void                 _loadTagsParallel(GAFStream* in, GAFAsset* asset);
+
 protected:
     typedef std::map</*Tags::Enum*/ uint32_t, DefinitionTagBase*> TagLoaders_t;
     TagLoaders_t         m_tagLoaders;
@@ -44,6 +64,20 @@ public:
 
     void                 registerTagLoader(unsigned int idx, DefinitionTagBase*);
 
+    /// Top level timelines of GAF v4+ files are decoded on several threads. Enabled by default.
+    /// @note it is not used when custom tag loaders are registered
+    void                 setParallelTimelineLoading(bool value);
+
+    /// Only tags that refer to external resources (atlases, text fields and sounds) are parsed,
+    /// all other ones including frames of nested timelines are skipped by their length.
+    /// Timelines are loaded without objects, frames and sequences. Disabled by default
+    void                 setScanResourcesOnly(bool value);
+
+    /// Only timelines with the given linkage names and timelines they contain are loaded, together with
+    /// their atlases. Other timelines are skipped by their length. Empty by default - all timelines are loaded.
+    /// @note GAF v4+ only. The first found timeline becomes the root one
+    void                 setRootTimelines(const std::vector<std::string>& linkageNames);
+
     void                 loadTags(GAFStream* in, GAFAsset* asset, GAFTimeline* timeline);
 };
 
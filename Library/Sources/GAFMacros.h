@@ -37,4 +37,54 @@ for (__type::iterator i = __instance.begin(), e = __instance.end(); i != e; ++i)
 #define GAF_ENABLE_NEW_UNIFORM_SETTER COCOS2D_VERSION >= 0x00030200
 #endif
 
+#ifndef GAF_ENABLE_FILE_MAPPING
+// GAF files are mapped read-only instead of being copied to the heap where the file system allows it
+#define GAF_ENABLE_FILE_MAPPING (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+#endif
+
+#ifndef GAF_KEYFRAME_INTERVAL
+// Every n-th animation frame stores the complete set of object states, frames in between store changes only
+#define GAF_KEYFRAME_INTERVAL 32
+#endif
+
+#ifndef GAF_ARENA_BLOCK_SIZE
+// Size of memory blocks the asset arena allocates parsed frames and filters from
+#define GAF_ARENA_BLOCK_SIZE (64 * 1024)
+#endif
+
+#ifndef GAF_ASSET_CACHE_BUDGET
+// Bytes of parsed data and textures GAFAssetCache keeps before it starts to drop unused assets
+#define GAF_ASSET_CACHE_BUDGET (64 * 1024 * 1024)
+#endif
+
+#ifndef GAF_ATLAS_LOD_MARGIN
+// Part of an atlas scale the on-screen scale of an object has to go below it by before the object
+// switches to that smaller atlas, so objects scaled around a threshold do not flip between atlases
+#define GAF_ATLAS_LOD_MARGIN 0.1f
+#endif
+
+#ifndef GAF_TEXTURE_UPLOAD_BUDGET
+// Milliseconds GAFTextureUploadScheduler spends on creating textures every frame
+#define GAF_TEXTURE_UPLOAD_BUDGET 4.f
+#endif
+
+#ifndef GAF_KEEP_IMAGES_FOR_CONTEXT_LOSS
+// Keeps decoded atlas images after upload when textures are restored by VolatileTextureMgr.
+// Otherwise images read from files are released and reloaded from the files when the GL context is lost.
+// Always on for cocos2d-x 3.1.1 and older, where alpha of atlas images is premultiplied by GAF
+#define GAF_KEEP_IMAGES_FOR_CONTEXT_LOSS 0
+#endif
+
+#ifndef GAF_ENABLE_CATCH_UP
+// When an update plays several frames of an object, all but the last one only advance and perform their
+// actions and delegates, states are applied to nodes for the last frame only
+#define GAF_ENABLE_CATCH_UP 1
+#endif
+
+#ifndef GAF_PARALLEL_EVALUATION_THRESHOLD
+// Number of objects stepping in one update from which GAFAnimationManager evaluates top-level ones on worker
+// threads before their frames are applied to nodes on the main thread, 0 keeps everything on the main thread
+#define GAF_PARALLEL_EVALUATION_THRESHOLD 32
+#endif
+
 #define CHECK_CTX_IDENTITY 1
@@ -82,6 +82,22 @@ bool GAFMovieClip::initWithTexture(cocos2d::Texture2D *pTexture, const cocos2d::
     }
 }
 
+void GAFMovieClip::replaceSpriteFrame(cocos2d::SpriteFrame *spriteFrame, GAFRotation rotation)
+{
+    GAFSprite::replaceSpriteFrame(spriteFrame, rotation);
+
+    spriteFrame->getTexture()->retain();
+    CC_SAFE_RELEASE(m_initialTexture);
+    m_initialTexture = spriteFrame->getTexture();
+    m_initialTextureRect = spriteFrame->getRect();
+
+    // Filtered texture is made of the initial one
+    if (m_blurFilterData || m_glowFilterData)
+    {
+        updateTextureWithEffects();
+    }
+}
+
 void GAFMovieClip::setGLProgram(GLProgram *glProgram)
 {
     if (_glProgramState == nullptr || (_glProgramState && _glProgramState->getGLProgram() != glProgram))
@@ -38,6 +38,7 @@ public:
     virtual ~GAFMovieClip();
 
     virtual bool initWithTexture(cocos2d::Texture2D *pTexture, const cocos2d::Rect& rect, bool rotated) override;
+    virtual void replaceSpriteFrame(cocos2d::SpriteFrame *spriteFrame, GAFRotation rotation) override;
 
     void setColorTransform(const GLfloat * mults, const GLfloat * offsets);
     void setColorTransform(const GLfloat * colorTransform);
@@ -11,6 +11,7 @@
 #include "GAFSubobjectState.h"
 #include "GAFFilterData.h"
 #include "GAFTextField.h"
+#include "GAFAnimationManager.h"
 
 #include <math/TransformUtils.h>
 
@@ -20,6 +21,35 @@ NS_GAF_BEGIN
 
 static const AnimationSequences_t s_emptySequences = AnimationSequences_t();
 
+// Places the sprite showing the element like the element is placed in the timeline
+static void setupElementSprite(GAFSprite* sprite, const GAFTextureAtlasElement* element)
+{
+    cocos2d::Vect pt = cocos2d::Vect(0 - (0 - (element->pivotPoint.x / sprite->getContentSize().width)),
+        0 + (1 - (element->pivotPoint.y / sprite->getContentSize().height)));
+    sprite->setAnchorPoint(pt);
+
+    sprite->setAtlasScale(1.0f / element->getScale());
+}
+
+// The smallest scale that is not below the given one, or the biggest scale
+static float chooseAtlasScale(const std::vector<float>& scales, float scale)
+{
+    float result = 0.f;
+    float biggest = 0.f;
+
+    for (float s : scales)
+    {
+        if (s >= scale && (result == 0.f || s < result))
+        {
+            result = s;
+        }
+
+        biggest = std::max(biggest, s);
+    }
+
+    return result != 0.f ? result : biggest;
+}
+
 cocos2d::AffineTransform GAFObject::GAF_CGAffineTransformCocosFormatFromFlashFormat(cocos2d::AffineTransform aTransform)
 {
     cocos2d::AffineTransform transform = aTransform;
@@ -35,22 +65,29 @@ GAFObject::GAFObject() :
 m_timelineParentObject(nullptr),
 m_container(nullptr),
 m_totalFrameCount(0),
-m_currentSequenceStart(0),
-m_currentSequenceEnd(0),
-m_isRunning(false),
-m_isLooped(false),
-m_isReversed(false),
-m_timeDelta(0.0),
 m_fps(0),
 m_skipFpsCheck(false),
+m_isCatchUpEnabled(GAF_ENABLE_CATCH_UP != 0),
+m_isCatchingUp(false),
 m_asset(nullptr),
 m_timeline(nullptr),
-m_currentFrame(GAFFirstFrameIndex),
-m_showingFrame(GAFFirstFrameIndex),
 m_lastVisibleInFrame(0),
+m_frameStatesIndex(IDNONE),
+m_realizedFrame(IDNONE),
+m_realizedOpacity(0),
+m_realizedCameraMask(0),
+m_realizedFlippedX(false),
+m_realizedFlippedY(false),
 m_objectType(GAFObjectType::None),
 m_animationsSelectorScheduled(false),
-m_isInResetState(false)
+m_animationGroup(0),
+m_animationIndex(0),
+m_isTickPaused(false),
+m_isEvaluated(false),
+m_evaluator(nullptr),
+m_isEvaluationSupported(true),
+m_atlasLodEnabled(false),
+m_atlasLodScale(0.f)
 {
     m_charType = GAFCharacterType::Timeline;
     m_parentColorTransforms[0] = cocos2d::Vec4::ONE;
@@ -59,6 +96,8 @@ m_isInResetState(false)
 
 GAFObject::~GAFObject()
 {
+    enableTick(false);
+    CC_SAFE_DELETE(m_evaluator);
     GAF_SAFE_RELEASE_ARRAY_WITH_NULL_CHECK(MaskList_t, m_masks);
     GAF_SAFE_RELEASE_ARRAY_WITH_NULL_CHECK(DisplayList_t, m_displayList);
     CC_SAFE_RELEASE(m_asset);
@@ -100,14 +139,17 @@ bool GAFObject::init(GAFAsset * anAnimationData, GAFTimeline* timeline)
         CC_SAFE_RELEASE(m_timeline);
         m_timeline = timeline;
         CC_SAFE_RETAIN(m_timeline);
+
+        m_frameStates.clear();
+        m_frameStatesIndex = IDNONE;
     }
     m_container = cocos2d::Node::create();
     addChild(m_container);
     m_container->setContentSize(getContentSize());
 
-    m_currentSequenceStart = m_currentFrame = GAFFirstFrameIndex;
+    m_cursor.sequenceStart = m_cursor.currentFrame = GAFFirstFrameIndex;
 
-    m_currentSequenceEnd = m_totalFrameCount = m_timeline->getFramesCount();
+    m_cursor.sequenceEnd = m_totalFrameCount = m_timeline->getFramesCount();
 
     constructObject();
 
@@ -122,9 +164,14 @@ void GAFObject::constructObject()
 
     GAF_SAFE_RELEASE_ARRAY_WITH_NULL_CHECK(DisplayList_t, m_displayList);
 
+    // The evaluator is bound to the nodes of the display list
+    CC_SAFE_DELETE(m_evaluator);
+    m_evaluatedNodes.clear();
+    m_isEvaluationSupported = true;
+
     m_fps = m_asset->getSceneFps();
 
-    m_animationsSelectorScheduled = false;
+    m_realizedFrame = IDNONE;
 
     instantiateObject(m_timeline->getAnimationObjects(), m_timeline->getAnimationMasks());
 }
@@ -176,14 +223,7 @@ GAFObject* GAFObject::_instantiateObject(uint32_t id, GAFCharacterType type, uin
                 result = new GAFMask();
             result->initWithSpriteFrame(spriteFrame, txElemet->rotation);
             result->objectIdRef = id;
-            cocos2d::Vect pt = cocos2d::Vect(0 - (0 - (txElemet->pivotPoint.x / result->getContentSize().width)),
-                0 + (1 - (txElemet->pivotPoint.y / result->getContentSize().height)));
-            result->setAnchorPoint(pt);
-
-            if (txElemet->getScale() != 1.0f)
-            {
-                result->setAtlasScale(1.0f / txElemet->getScale());
-            }
+            setupElementSprite(result, txElemet);
             result->setBlendFunc(cocos2d::BlendFunc::ALPHA_PREMULTIPLIED);
         }
     }
@@ -233,6 +273,109 @@ void GAFObject::instantiateObject(const AnimationObjects_t& objs, const Animatio
     }
 }
 
+void GAFObject::_setObjectAtlasScale(uint32_t id, GAFCharacterType type, uint32_t reference, float scale)
+{
+    GAFObject* object = id < m_displayList.size() ? m_displayList[id] : nullptr;
+    if (!object)
+    {
+        return;
+    }
+
+    if (type == GAFCharacterType::Timeline)
+    {
+        object->setAtlasLodScale(scale);
+        return;
+    }
+
+    if (type != GAFCharacterType::Texture)
+    {
+        return;
+    }
+
+    GAFTextureAtlas* atlas = m_timeline->getTextureAtlasForScale(scale);
+    if (!atlas)
+    {
+        return;
+    }
+
+    GAFAssetTextureManager* txMgr = m_asset->getTextureManager(m_timeline, atlas);
+    const GAFTextureAtlas::Elements_t& elementsMap = atlas->getElements();
+    GAFTextureAtlas::Elements_t::const_iterator elIt = elementsMap.find(reference);
+    if (!txMgr || elIt == elementsMap.end())
+    {
+        return;
+    }
+
+    const GAFTextureAtlasElement* txElemet = elIt->second;
+    cocos2d::Texture2D* texture = txMgr->getTextureById(txElemet->atlasIdx + 1);
+    if (!texture)
+    {
+        CCLOGERROR("Cannot switch sub object with Id: %d to atlas scale %f, atlas with idx: %d not found.", id, atlas->getScale(), txElemet->atlasIdx);
+        return;
+    }
+
+    object->replaceSpriteFrame(cocos2d::SpriteFrame::createWithTexture(texture, txElemet->bounds), txElemet->rotation);
+    setupElementSprite(object, txElemet);
+}
+
+void GAFObject::setAtlasLodScale(float scale)
+{
+    m_atlasLodScale = scale;
+
+    // Replaced sprite frames get all states applied again
+    m_realizedFrame = IDNONE;
+
+    const AnimationObjects_t& objects = m_timeline->getAnimationObjects();
+    for (AnimationObjects_t::const_iterator i = objects.begin(), e = objects.end(); i != e; ++i)
+    {
+        _setObjectAtlasScale(i->first, std::get<1>(i->second), std::get<0>(i->second), scale);
+    }
+
+    const AnimationMasks_t& masks = m_timeline->getAnimationMasks();
+    for (AnimationMasks_t::const_iterator i = masks.begin(), e = masks.end(); i != e; ++i)
+    {
+        _setObjectAtlasScale(i->first, std::get<1>(i->second), std::get<0>(i->second), scale);
+    }
+}
+
+float GAFObject::getAtlasLodScale() const
+{
+    return m_atlasLodScale;
+}
+
+void GAFObject::setAtlasLodEnabled(bool value)
+{
+    m_atlasLodEnabled = value;
+}
+
+bool GAFObject::isAtlasLodEnabled() const
+{
+    return m_atlasLodEnabled;
+}
+
+void GAFObject::_updateAtlasLod()
+{
+    const std::vector<float>& scales = m_asset->getHeader().scaleValues;
+    if (scales.size() < 2)
+    {
+        return;
+    }
+
+    const cocos2d::AffineTransform t = getNodeToWorldAffineTransform();
+    const float screenScale = sqrtf(fabsf(t.a * t.d - t.b * t.c));
+
+    float scale = chooseAtlasScale(scales, screenScale);
+    if (scale < m_atlasLodScale)
+    {
+        scale = chooseAtlasScale(scales, screenScale * (1.f + GAF_ATLAS_LOD_MARGIN));
+    }
+
+    if (scale != m_atlasLodScale)
+    {
+        setAtlasLodScale(scale);
+    }
+}
+
 GAFObject* GAFObject::encloseNewTimeline(uint32_t reference)
 {
     Timelines_t& timelines = m_asset->getTimelines();
@@ -255,12 +398,12 @@ void GAFObject::useExternalTextureAtlas(std::vector<cocos2d::Texture2D*>& textur
 
 void GAFObject::processAnimation()
 {
-    realizeFrame(m_container, m_currentFrame);
+    realizeFrame(m_container, m_cursor.currentFrame);
 }
 
 void GAFObject::setAnimationRunning(bool value, bool recursive)
 {
-    m_isRunning = value;
+    m_cursor.isRunning = value;
 
     if (recursive)
     {
@@ -277,7 +420,7 @@ void GAFObject::setAnimationRunning(bool value, bool recursive)
 
 bool GAFObject::getIsAnimationRunning() const
 {
-    return m_isRunning;
+    return m_cursor.isRunning;
 }
 
 void GAFObject::setSequenceDelegate(GAFSequenceDelegate_t delegate)
@@ -304,9 +447,9 @@ void GAFObject::start()
 {
     enableTick(true);
 
-    if (!m_isRunning)
+    if (!m_cursor.isRunning)
     {
-        m_currentFrame = m_isReversed ? m_totalFrameCount - 1 : GAFFirstFrameIndex;
+        m_cursor.currentFrame = m_cursor.isReversed ? m_totalFrameCount - 1 : GAFFirstFrameIndex;
         setAnimationRunning(true, true);
     }
 }
@@ -314,43 +457,31 @@ void GAFObject::start()
 void GAFObject::stop()
 {
     enableTick(false);
-    if (m_isRunning)
+    if (m_cursor.isRunning)
     {
-        m_currentFrame = GAFFirstFrameIndex;
+        m_cursor.currentFrame = GAFFirstFrameIndex;
         setAnimationRunning(false, true);
     }
 }
 
-void GAFObject::processAnimations(float dt)
+void GAFObject::processAnimations(uint32_t framesCount)
 {
-    if (m_skipFpsCheck)
+    for (uint32_t i = 0; i < framesCount; ++i)
     {
+        // Nodes of frames the last one replaces anyway are not touched
+        m_isCatchingUp = m_isCatchUpEnabled && i + 1 < framesCount;
         step();
+
         if (m_framePlayedDelegate)
         {
-            m_framePlayedDelegate(this, m_currentFrame);
-        }
-    }
-    else
-    {
-        m_timeDelta += dt;
-        double frameTime = 1.0 / m_fps;
-        while (m_timeDelta >= frameTime)
-        {
-            m_timeDelta -= frameTime;
-            step();
-
-            if (m_framePlayedDelegate)
-            {
-                m_framePlayedDelegate(this, m_currentFrame);
-            }
+            m_framePlayedDelegate(this, m_cursor.currentFrame);
         }
     }
 }
 
 void GAFObject::pauseAnimation()
 {
-    if (m_isRunning)
+    if (m_cursor.isRunning)
     {
         setAnimationRunning(false, false);
     }
@@ -358,7 +489,7 @@ void GAFObject::pauseAnimation()
 
 void GAFObject::resumeAnimation()
 {
-    if (!m_isRunning)
+    if (!m_cursor.isRunning)
     {
         setAnimationRunning(true, false);
     }
@@ -366,31 +497,31 @@ void GAFObject::resumeAnimation()
 
 bool GAFObject::isDone() const
 {
-    if (m_isLooped)
+    if (m_cursor.isLooped)
     {
         return false;
     }
 
     return isCurrentFrameLastInSequence();
     
-    /*if (!m_isReversed)
+    /*if (!m_cursor.isReversed)
     {
-        return m_currentFrame > m_totalFrameCount;
+        return m_cursor.currentFrame > m_totalFrameCount;
     }
     else
     {
-        return m_currentFrame < GAFFirstFrameIndex - 1;
+        return m_cursor.currentFrame < GAFFirstFrameIndex - 1;
     }*/
 }
 
 bool GAFObject::isLooped() const
 {
-    return m_isLooped;
+    return m_cursor.isLooped;
 }
 
 void GAFObject::setLooped(bool looped, bool recursive /*= false*/)
 {
-    m_isLooped = looped;
+    m_cursor.isLooped = looped;
 
     if (recursive)
     {
@@ -407,15 +538,15 @@ void GAFObject::setLooped(bool looped, bool recursive /*= false*/)
 
 bool GAFObject::isReversed() const
 {
-    return m_isReversed;
+    return m_cursor.isReversed;
 }
 
 void GAFObject::setReversed(bool reversed, bool fromCurrentFrame /* = true */)
 {
-    m_isReversed = reversed;
+    m_cursor.isReversed = reversed;
     if (!fromCurrentFrame)
     {
-        m_currentFrame = reversed ? m_currentSequenceEnd - 1 : m_currentSequenceStart;
+        m_cursor.currentFrame = reversed ? m_cursor.sequenceEnd - 1 : m_cursor.sequenceStart;
     }
 
     for (auto obj : m_displayList)
@@ -435,14 +566,14 @@ uint32_t GAFObject::getTotalFrameCount() const
 
 uint32_t GAFObject::getCurrentFrameIndex() const
 {
-    return m_showingFrame;
+    return m_cursor.showingFrame;
 }
 
 bool GAFObject::setFrame(uint32_t index)
 {
     if (index < m_totalFrameCount)
     {
-        m_showingFrame = m_currentFrame = index;
+        m_cursor.showingFrame = m_cursor.currentFrame = index;
         processAnimation();
         return true;
     }
@@ -451,15 +582,10 @@ bool GAFObject::setFrame(uint32_t index)
 
 bool GAFObject::gotoAndStop(const std::string& frameLabel)
 {
-    uint32_t f = getStartFrame(frameLabel);
+    uint32_t f = GAFTimelineCursor::findFrame(m_timeline, frameLabel);
     if (IDNONE == f)
     {
-        uint32_t frameNumber = atoi(frameLabel.c_str());
-        if (frameNumber == 0)
-        {
-            return false;
-        }
-        return gotoAndStop(frameNumber - 1);
+        return false;
     }
     return gotoAndStop(f);
 }
@@ -468,7 +594,7 @@ bool GAFObject::gotoAndStop(uint32_t frameNumber)
 {
     if (setFrame(frameNumber))
     {
-        m_isRunning = false;
+        m_cursor.isRunning = false;
         return true;
     }
     return false;
@@ -476,15 +602,10 @@ bool GAFObject::gotoAndStop(uint32_t frameNumber)
 
 bool GAFObject::gotoAndPlay(const std::string& frameLabel)
 {
-    uint32_t f = getStartFrame(frameLabel);
+    uint32_t f = GAFTimelineCursor::findFrame(m_timeline, frameLabel);
     if (IDNONE == f)
     {
-        uint32_t frameNumber = atoi(frameLabel.c_str());
-        if (frameNumber == 0)
-        {
-            return false;
-        }
-        return gotoAndPlay(frameNumber - 1);
+        return false;
     }
     return gotoAndPlay(f);
 }
@@ -493,7 +614,7 @@ bool GAFObject::gotoAndPlay(uint32_t frameNumber)
 {
     if (setFrame(frameNumber))
     {
-        m_isRunning = true;
+        m_cursor.isRunning = true;
         return true;
     }
     return false;
@@ -549,10 +670,10 @@ bool GAFObject::playSequence(const std::string& name, bool looped, bool resume /
         return false;
     }
 
-    m_currentSequenceStart = s;
-    m_currentSequenceEnd = e;
+    m_cursor.sequenceStart = s;
+    m_cursor.sequenceEnd = e;
 
-    m_currentFrame = m_isReversed ? (e - 1) : (s);
+    m_cursor.currentFrame = m_cursor.isReversed ? (e - 1) : (s);
     
     setLooped(looped, false);
 
@@ -570,13 +691,13 @@ bool GAFObject::playSequence(const std::string& name, bool looped, bool resume /
 
 void GAFObject::clearSequence()
 {
-    m_currentSequenceStart = GAFFirstFrameIndex;
-    m_currentSequenceEnd = m_totalFrameCount;
+    m_cursor.sequenceStart = GAFFirstFrameIndex;
+    m_cursor.sequenceEnd = m_totalFrameCount;
 }
 
 void GAFObject::step()
 {
-    m_showingFrame = m_currentFrame;
+    m_cursor.showingFrame = m_cursor.currentFrame;
 
     if (!getIsAnimationRunning())
     {
@@ -587,13 +708,13 @@ void GAFObject::step()
     if (m_sequenceDelegate && m_timeline)
     {
         const GAFAnimationSequence * seq = nullptr;
-        if (!m_isReversed)
+        if (!m_cursor.isReversed)
         {
-            seq = m_timeline->getSequenceByLastFrame(m_currentFrame);
+            seq = m_timeline->getSequenceByLastFrame(m_cursor.currentFrame);
         }
         else
         {
-            seq = m_timeline->getSequenceByFirstFrame(m_currentFrame + 1);
+            seq = m_timeline->getSequenceByFirstFrame(m_cursor.currentFrame + 1);
         }
 
         if (seq)
@@ -604,7 +725,7 @@ void GAFObject::step()
 
     if (isCurrentFrameLastInSequence())
     {
-        if (m_isLooped)
+        if (m_cursor.isLooped)
         {
             if (m_animationStartedNextLoopDelegate)
                 m_animationStartedNextLoopDelegate(this);
@@ -620,31 +741,17 @@ void GAFObject::step()
 
     processAnimation();
 
-    m_showingFrame = m_currentFrame;
-    m_currentFrame = nextFrame();
+    m_cursor.advance();
 }
 
 bool GAFObject::isCurrentFrameLastInSequence() const
 {
-    if (m_isReversed)
-        return m_currentFrame == m_currentSequenceStart;
-    return m_currentFrame == m_currentSequenceEnd - 1;
+    return m_cursor.isLastFrameInSequence();
 }
 
 uint32_t GAFObject::nextFrame()
 {
-    if (isCurrentFrameLastInSequence())
-    {
-        if (!m_isLooped)
-            return m_currentFrame;
-
-        if (m_isReversed)
-            return m_currentSequenceEnd - 1;
-        else
-            return m_currentSequenceStart;
-    }
-
-    return m_currentFrame + (m_isReversed ? -1 : 1);
+    return m_cursor.nextFrame();
 }
 
 bool GAFObject::hasSequences() const
@@ -770,268 +877,556 @@ void GAFObject::realizeFrame(cocos2d::Node* out, uint32_t frameIndex)
 
     GAFAnimationFrame *currentFrame = animationFrames[frameIndex];
 
-    const GAFAnimationFrame::SubobjectStates_t& states = currentFrame->getObjectStates();
+    const GAFStateStore& store = m_timeline->getStates();
+    const uint32_t* objectIds = store.getObjectIds();
+    const float* allColorMults = store.getColorMults();
+    const float* allColorOffsets = store.getColorOffsets();
+
+    // Going to the next or the previous frame only the states that differ are applied again, unless
+    // anything states are combined with has changed since the realized frame
+    const uint32_t* changedSlots = nullptr;
+    uint32_t changedSlotsCount = 0;
+    bool isChangeDriven = !m_isCatchingUp && _isRealizedFrameCurrent();
+
+    bool isStatic = isChangeDriven && frameIndex == m_realizedFrame;
+
+    if (isChangeDriven && frameIndex != m_realizedFrame)
+    {
+        if (frameIndex == m_realizedFrame + 1)
+        {
+            isStatic = m_timeline->isStaticFrame(frameIndex);
+            m_timeline->getChangedSlots(frameIndex, changedSlots, changedSlotsCount);
+        }
+        else if (frameIndex + 1 == m_realizedFrame)
+        {
+            isStatic = m_timeline->isStaticFrame(m_realizedFrame);
+            m_timeline->getChangedSlots(m_realizedFrame, changedSlots, changedSlotsCount);
+        }
+        else
+        {
+            isChangeDriven = false;
+        }
+    }
+
+    // States of a static frame are the ones of the realized frame
+    if (isStatic && m_frameStatesIndex == m_realizedFrame)
+    {
+        m_frameStatesIndex = frameIndex;
+    }
+    else
+    {
+        m_timeline->getFrameStates(frameIndex, m_frameStates, m_frameStatesIndex);
+    }
+
+    // Nodes are left as they are when catching up, the next realized frame applies every state
+    _setRealizedFrame(m_isCatchingUp ? IDNONE : frameIndex);
+
+    if (isStatic && _realizeStaticFrame(frameIndex))
+    {
+        m_cursor.performActions(currentFrame, m_timeline, m_asset, _eventDispatcher, [this]() { processAnimation(); });
+        return;
+    }
+
+    const uint32_t* changedSlotsEnd = changedSlots + changedSlotsCount;
 
-    for (const GAFSubobjectState* state : states)
+    for (uint32_t slot = 0, slotsCount = static_cast<uint32_t>(m_frameStates.size()); slot < slotsCount; ++slot)
     {
-        GAFObject* subObject = m_displayList[state->objectIdRef];
+        const uint32_t state = m_frameStates[slot];
+
+        bool isChanged = !isChangeDriven;
+        if (isChangeDriven && changedSlots != changedSlotsEnd && *changedSlots == slot)
+        {
+            isChanged = true;
+            ++changedSlots;
+        }
+
+        const uint32_t objectId = objectIds[state];
+        const float* stateColorMults = allColorMults + state * 4;
+        const float* stateColorOffsets = allColorOffsets + state * 4;
+        const bool isVisible = store.isVisible(state);
+
+        GAFObject* subObject = m_displayList[objectId];
 
         CCASSERT(subObject, "Error. SubObject with current ID not found");
         if (!subObject)
             continue;
 
-        if (state->colorMults()[GAFColorTransformIndex::GAFCTI_A] >= 0.f && subObject->m_isInResetState)
-        {
-            subObject->m_currentFrame = subObject->m_currentSequenceStart;
-        }
-        subObject->m_isInResetState = state->colorMults()[GAFColorTransformIndex::GAFCTI_A] < 0.f;
+        subObject->m_cursor.updateResetState(stateColorMults[GAFColorTransformIndex::GAFCTI_A]);
 
-        if (!state->isVisible())
+        if (!isVisible)
             continue;
 
-        if (subObject->m_charType == GAFCharacterType::Timeline)
+        if (m_isCatchingUp)
         {
-            if (!subObject->m_isInResetState)
+            // Enclosed timelines keep playing and performing their actions
+            if (subObject->m_charType == GAFCharacterType::Timeline && !subObject->m_cursor.isInResetState)
             {
-                cocos2d::AffineTransform stateTransform = state->affineTransform;
-                float csf = m_timeline->usedAtlasScale();
-                stateTransform.tx *= csf;
-                stateTransform.ty *= csf;
-                cocos2d::AffineTransform t = GAF_CGAffineTransformCocosFormatFromFlashFormat(state->affineTransform);
-                subObject->setAdditionalTransform(t);
-                subObject->m_parentFilters.clear();
-                const Filters_t& filters = state->getFilters();
-                subObject->m_parentFilters.insert(subObject->m_parentFilters.end(), filters.begin(), filters.end());
-
-                const float* cm = state->colorMults();
-                subObject->m_parentColorTransforms[0] = cocos2d::Vec4(
-                    m_parentColorTransforms[0].x * cm[0],
-                    m_parentColorTransforms[0].y * cm[1],
-                    m_parentColorTransforms[0].z * cm[2],
-                    m_parentColorTransforms[0].w * cm[3]);
-                subObject->m_parentColorTransforms[1] = cocos2d::Vec4(state->colorOffsets()) + m_parentColorTransforms[1];
-
-                if (m_masks[state->objectIdRef])
-                {
-                    rearrangeSubobject(out, m_masks[state->objectIdRef], state->zIndex);
-                }
-                else
-                {
-                    //subObject->removeFromParentAndCleanup(false);
-                    if (state->maskObjectIdRef == IDNONE)
-                    {
-                        rearrangeSubobject(out, subObject, state->zIndex);
-                    }
-                    else
-                    {
-                        // If the state has a mask, then attach it 
-                        // to the clipping node. Clipping node will be attached on its state
-                        auto mask = m_masks[state->maskObjectIdRef];
-                        CCASSERT(mask, "Error. No mask found for this ID");
-                        if (mask)
-                            rearrangeSubobject(mask, subObject, state->zIndex);
-                    }
-                }
-
+                subObject->m_isCatchingUp = true;
                 subObject->step();
+                subObject->m_isCatchingUp = false;
             }
+
+            subObject->m_lastVisibleInFrame = frameIndex + 1;
+            continue;
         }
-        else if (subObject->m_charType == GAFCharacterType::Texture)
+
+        const bool isTimeline = subObject->m_charType == GAFCharacterType::Timeline;
+        const bool isStepped = isTimeline && !subObject->m_cursor.isInResetState;
+
+        // Sprites moved or scaled since their states were applied get them applied again
+        const bool isApplied = isTimeline ? isStepped && isChanged
+            : isChanged || (subObject->m_charType == GAFCharacterType::Texture && subObject->isExternalTransformDirty());
+
+        if (isApplied)
         {
-            cocos2d::Vect prevAP = subObject->getAnchorPoint();
-            cocos2d::Size  prevCS = subObject->getContentSize();
+            const float colorMults[4] = {
+                stateColorMults[0] * m_parentColorTransforms[0].x,
+                stateColorMults[1] * m_parentColorTransforms[0].y,
+                stateColorMults[2] * m_parentColorTransforms[0].z,
+                stateColorMults[3] * m_parentColorTransforms[0].w
+            };
+            const float colorOffsets[4] = {
+                stateColorOffsets[0] + m_parentColorTransforms[1].x,
+                stateColorOffsets[1] + m_parentColorTransforms[1].y,
+                stateColorOffsets[2] + m_parentColorTransforms[1].z,
+                stateColorOffsets[3] + m_parentColorTransforms[1].w
+            };
+
+            _applyState(out, subObject, state, colorMults, colorOffsets);
+        }
 
-#if ENABLE_RUNTIME_FILTERS
-            if (subObject->m_objectType == GAFObjectType::MovieClip)
-            {
-                // Validate sprite type (w/ or w/o filter)
-                const Filters_t& filters = state->getFilters();
-                GAFFilterData* filter = NULL;
+        if (isStepped)
+        {
+            subObject->step();
+        }
 
-                GAFMovieClip* mc = static_cast<GAFMovieClip*>(subObject);
+        subObject->m_lastVisibleInFrame = frameIndex + 1;
+    }
 
-                if (m_parentFilters.size() > 0)
-                {
-                    filter = *m_parentFilters.begin();
-                }
-                else if (filters.size() > 0)
-                {
-                    filter = *filters.begin();
-                }
+    m_cursor.performActions(currentFrame, m_timeline, m_asset, _eventDispatcher, [this]() { processAnimation(); });
+}
 
-                if (filter)
-                {
-                    filter->apply(mc);
-                }
+void GAFObject::_applyState(cocos2d::Node* out, GAFObject* subObject, uint32_t state, const float* colorMults, const float* colorOffsets)
+{
+    const GAFStateStore& store = m_timeline->getStates();
+    const uint32_t objectId = store.getObjectIds()[state];
+    const uint32_t maskObjectId = store.getMaskObjectIds()[state];
+    const int zIndex = store.getZIndices()[state];
+    const cocos2d::AffineTransform& affineTransform = store.getTransforms()[state];
 
-                if (!filter || filter->getType() != GAFFilterType::Blur)
-                {
-                    mc->setBlurFilterData(nullptr);
-                }
+    if (subObject->m_charType == GAFCharacterType::Timeline)
+    {
+        cocos2d::AffineTransform stateTransform = affineTransform;
+        float csf = m_timeline->usedAtlasScale();
+        stateTransform.tx *= csf;
+        stateTransform.ty *= csf;
+        cocos2d::AffineTransform t = GAF_CGAffineTransformCocosFormatFromFlashFormat(affineTransform);
+        subObject->setAdditionalTransform(t);
+
+        // The nested timeline combines them with its own states, it applies all of them again when they change
+        const Filters_t& filters = store.getFilters(state);
+        if (subObject->m_parentFilters != filters)
+        {
+            subObject->m_parentFilters.assign(filters.begin(), filters.end());
+            subObject->m_realizedFrame = IDNONE;
+        }
 
-                if (!filter || filter->getType() != GAFFilterType::ColorMatrix)
-                {
-                    mc->setColorMarixFilterData(nullptr);
-                }
+        const cocos2d::Vec4 parentColorMults = cocos2d::Vec4(colorMults);
+        const cocos2d::Vec4 parentColorOffsets = cocos2d::Vec4(colorOffsets);
 
-                if (!filter || filter->getType() != GAFFilterType::Glow)
-                {
-                    mc->setGlowFilterData(nullptr);
-                }
+        if (subObject->m_parentColorTransforms[0] != parentColorMults || subObject->m_parentColorTransforms[1] != parentColorOffsets)
+        {
+            subObject->m_parentColorTransforms[0] = parentColorMults;
+            subObject->m_parentColorTransforms[1] = parentColorOffsets;
+            subObject->m_realizedFrame = IDNONE;
+        }
 
-                if (!filter || filter->getType() != GAFFilterType::DropShadow)
-                {
-                    GAFDropShadowFilterData::reset(mc);
-                }
+        if (m_masks[objectId])
+        {
+            rearrangeSubobject(out, m_masks[objectId], zIndex);
+        }
+        else
+        {
+            //subObject->removeFromParentAndCleanup(false);
+            if (maskObjectId == IDNONE)
+            {
+                rearrangeSubobject(out, subObject, zIndex);
             }
-#endif
+            else
+            {
+                // If the state has a mask, then attach it 
+                // to the clipping node. Clipping node will be attached on its state
+                auto mask = m_masks[maskObjectId];
+                CCASSERT(mask, "Error. No mask found for this ID");
+                if (mask)
+                    rearrangeSubobject(mask, subObject, zIndex);
+            }
+        }
+    }
+    else if (subObject->m_charType == GAFCharacterType::Texture)
+    {
+        cocos2d::Vect prevAP = subObject->getAnchorPoint();
+        cocos2d::Size  prevCS = subObject->getContentSize();
 
-            cocos2d::Size newCS = subObject->getContentSize();
-            cocos2d::Vect newAP = cocos2d::Vect(((prevAP.x - 0.5f) * prevCS.width) / newCS.width + 0.5f,
-                ((prevAP.y - 0.5f) * prevCS.height) / newCS.height + 0.5f);
-            subObject->setAnchorPoint(newAP);
+#if ENABLE_RUNTIME_FILTERS
+        if (subObject->m_objectType == GAFObjectType::MovieClip)
+        {
+            // Validate sprite type (w/ or w/o filter)
+            const Filters_t& filters = store.getFilters(state);
+            GAFFilterData* filter = NULL;
 
+            GAFMovieClip* mc = static_cast<GAFMovieClip*>(subObject);
 
-            if (m_masks[state->objectIdRef])
+            if (m_parentFilters.size() > 0)
             {
-                rearrangeSubobject(out, m_masks[state->objectIdRef], state->zIndex);
+                filter = *m_parentFilters.begin();
             }
-            else
+            else if (filters.size() > 0)
             {
-                //subObject->removeFromParentAndCleanup(false);
-                if (state->maskObjectIdRef == IDNONE)
-                {
-                    rearrangeSubobject(out, subObject, state->zIndex);
-                }
-                else
-                {
-                    // If the state has a mask, then attach it 
-                    // to the clipping node. Clipping node will be attached on its state
-                    auto mask = m_masks[state->maskObjectIdRef];
-                    CCASSERT(mask, "Error. No mask found for this ID");
-                    if (mask)
-                        rearrangeSubobject(mask, subObject, state->zIndex);
-                }
+                filter = *filters.begin();
             }
 
-            cocos2d::AffineTransform stateTransform = state->affineTransform;
-            float csf = m_timeline->usedAtlasScale();
-            stateTransform.tx *= csf;
-            stateTransform.ty *= csf;
-            cocos2d::AffineTransform t = GAF_CGAffineTransformCocosFormatFromFlashFormat(state->affineTransform);
-            
-            if (isFlippedX() || isFlippedY())
+            if (filter)
             {
-                float flipMulX = isFlippedX() ? -1 : 1;
-                float flipOffsetX = isFlippedX() ? getContentSize().width - m_asset->getHeader().frameSize.getMinX() : 0;
-                float flipMulY = isFlippedY() ? -1 : 1;
-                float flipOffsetY = isFlippedY() ? -getContentSize().height + m_asset->getHeader().frameSize.getMinY() : 0;
+                filter->apply(mc);
+            }
 
-                cocos2d::AffineTransform flipCenterTransform = cocos2d::AffineTransformMake(flipMulX, 0, 0, flipMulY, flipOffsetX, flipOffsetY);
-                t = AffineTransformConcat(t, flipCenterTransform);
+            if (!filter || filter->getType() != GAFFilterType::Blur)
+            {
+                mc->setBlurFilterData(nullptr);
             }
 
-            cocos2d::Point curPos = subObject->getPosition();
-            if (curPos != cocos2d::Vec2::ZERO)
+            if (!filter || filter->getType() != GAFFilterType::ColorMatrix)
             {
-                t.tx += curPos.x;
-                t.ty += curPos.y;
+                mc->setColorMarixFilterData(nullptr);
             }
-            float curScale = subObject->getScale();
-            if (fabs(curScale - 1.0) > std::numeric_limits<float>::epsilon())
+
+            if (!filter || filter->getType() != GAFFilterType::Glow)
             {
-                t.a *= curScale;
-                t.d *= curScale;
+                mc->setGlowFilterData(nullptr);
             }
 
-            subObject->setExternalTransform(t);
+            if (!filter || filter->getType() != GAFFilterType::DropShadow)
+            {
+                GAFDropShadowFilterData::reset(mc);
+            }
+        }
+#endif
+
+        cocos2d::Size newCS = subObject->getContentSize();
+        cocos2d::Vect newAP = cocos2d::Vect(((prevAP.x - 0.5f) * prevCS.width) / newCS.width + 0.5f,
+            ((prevAP.y - 0.5f) * prevCS.height) / newCS.height + 0.5f);
+        subObject->setAnchorPoint(newAP);
+
 
-            if (subObject->m_objectType == GAFObjectType::MovieClip)
+        if (m_masks[objectId])
+        {
+            rearrangeSubobject(out, m_masks[objectId], zIndex);
+        }
+        else
+        {
+            //subObject->removeFromParentAndCleanup(false);
+            if (maskObjectId == IDNONE)
+            {
+                rearrangeSubobject(out, subObject, zIndex);
+            }
+            else
             {
-                GAFMovieClip* mc = static_cast<GAFMovieClip*>(subObject);
-                float colorMults[4] = {
-                    state->colorMults()[0] * m_parentColorTransforms[0].x * _displayedColor.r / 255,
-                    state->colorMults()[1] * m_parentColorTransforms[0].y * _displayedColor.g / 255,
-                    state->colorMults()[2] * m_parentColorTransforms[0].z * _displayedColor.b / 255,
-                    state->colorMults()[3] * m_parentColorTransforms[0].w * _displayedOpacity / 255
-                };
-                float colorOffsets[4] = {
-                    state->colorOffsets()[0] + m_parentColorTransforms[1].x,
-                    state->colorOffsets()[1] + m_parentColorTransforms[1].y,
-                    state->colorOffsets()[2] + m_parentColorTransforms[1].z,
-                    state->colorOffsets()[3] + m_parentColorTransforms[1].w
-                };
-
-                mc->setColorTransform(colorMults, colorOffsets);
+                // If the state has a mask, then attach it 
+                // to the clipping node. Clipping node will be attached on its state
+                auto mask = m_masks[maskObjectId];
+                CCASSERT(mask, "Error. No mask found for this ID");
+                if (mask)
+                    rearrangeSubobject(mask, subObject, zIndex);
             }
         }
-        else if (subObject->m_charType == GAFCharacterType::TextField)
+
+        cocos2d::AffineTransform stateTransform = affineTransform;
+        float csf = m_timeline->usedAtlasScale();
+        stateTransform.tx *= csf;
+        stateTransform.ty *= csf;
+        cocos2d::AffineTransform t = GAF_CGAffineTransformCocosFormatFromFlashFormat(affineTransform);
+        
+        if (isFlippedX() || isFlippedY())
         {
-            //GAFTextField *tf = static_cast<GAFTextField*>(subObject);
-            rearrangeSubobject(out, subObject, state->zIndex);
+            float flipMulX = isFlippedX() ? -1 : 1;
+            float flipOffsetX = isFlippedX() ? getContentSize().width - m_asset->getHeader().frameSize.getMinX() : 0;
+            float flipMulY = isFlippedY() ? -1 : 1;
+            float flipOffsetY = isFlippedY() ? -getContentSize().height + m_asset->getHeader().frameSize.getMinY() : 0;
 
-            cocos2d::AffineTransform stateTransform = state->affineTransform;
-            float csf = m_timeline->usedAtlasScale();
-            stateTransform.tx *= csf;
-            stateTransform.ty *= csf;
-            cocos2d::AffineTransform t = GAF_CGAffineTransformCocosFormatFromFlashFormat(state->affineTransform);
+            cocos2d::AffineTransform flipCenterTransform = cocos2d::AffineTransformMake(flipMulX, 0, 0, flipMulY, flipOffsetX, flipOffsetY);
+            t = AffineTransformConcat(t, flipCenterTransform);
+        }
 
-            if (isFlippedX() || isFlippedY())
-            {
-                float flipMulX = isFlippedX() ? -1 : 1;
-                float flipOffsetX = isFlippedX() ? getContentSize().width - m_asset->getHeader().frameSize.getMinX() : 0;
-                float flipMulY = isFlippedY() ? -1 : 1;
-                float flipOffsetY = isFlippedY() ? -getContentSize().height + m_asset->getHeader().frameSize.getMinY() : 0;
+        cocos2d::Point curPos = subObject->getPosition();
+        if (curPos != cocos2d::Vec2::ZERO)
+        {
+            t.tx += curPos.x;
+            t.ty += curPos.y;
+        }
+        float curScale = subObject->getScale();
+        if (fabs(curScale - 1.0) > std::numeric_limits<float>::epsilon())
+        {
+            t.a *= curScale;
+            t.d *= curScale;
+        }
 
-                cocos2d::AffineTransform flipCenterTransform = cocos2d::AffineTransformMake(flipMulX, 0, 0, flipMulY, flipOffsetX, flipOffsetY);
-                t = AffineTransformConcat(t, flipCenterTransform);
-            }
+        subObject->setExternalTransform(t);
 
-            subObject->setExternalTransform(t);
+        if (subObject->m_objectType == GAFObjectType::MovieClip)
+        {
+            GAFMovieClip* mc = static_cast<GAFMovieClip*>(subObject);
+            float displayedColorMults[4] = {
+                colorMults[0] * _displayedColor.r / 255,
+                colorMults[1] * _displayedColor.g / 255,
+                colorMults[2] * _displayedColor.b / 255,
+                colorMults[3] * _displayedOpacity / 255
+            };
+            float displayedColorOffsets[4] = { colorOffsets[0], colorOffsets[1], colorOffsets[2], colorOffsets[3] };
+
+            mc->setColorTransform(displayedColorMults, displayedColorOffsets);
         }
+    }
+    else if (subObject->m_charType == GAFCharacterType::TextField)
+    {
+        //GAFTextField *tf = static_cast<GAFTextField*>(subObject);
+        rearrangeSubobject(out, subObject, zIndex);
+
+        cocos2d::AffineTransform stateTransform = affineTransform;
+        float csf = m_timeline->usedAtlasScale();
+        stateTransform.tx *= csf;
+        stateTransform.ty *= csf;
+        cocos2d::AffineTransform t = GAF_CGAffineTransformCocosFormatFromFlashFormat(affineTransform);
 
-        if (state->isVisible())
+        if (isFlippedX() || isFlippedY())
         {
-            subObject->m_lastVisibleInFrame = frameIndex + 1;
+            float flipMulX = isFlippedX() ? -1 : 1;
+            float flipOffsetX = isFlippedX() ? getContentSize().width - m_asset->getHeader().frameSize.getMinX() : 0;
+            float flipMulY = isFlippedY() ? -1 : 1;
+            float flipOffsetY = isFlippedY() ? -getContentSize().height + m_asset->getHeader().frameSize.getMinY() : 0;
+
+            cocos2d::AffineTransform flipCenterTransform = cocos2d::AffineTransformMake(flipMulX, 0, 0, flipMulY, flipOffsetX, flipOffsetY);
+            t = AffineTransformConcat(t, flipCenterTransform);
+        }
+
+        subObject->setExternalTransform(t);
+    }
+}
+
+bool GAFObject::_realizeStaticFrame(uint32_t frameIndex)
+{
+    const GAFStateStore& store = m_timeline->getStates();
+    const uint32_t* objectIds = store.getObjectIds();
+    const float* allColorMults = store.getColorMults();
+
+    // Sprites moved or scaled after their states were applied get them applied again, see realizeFrame
+    for (uint32_t state : m_frameStates)
+    {
+        const GAFObject* subObject = m_displayList[objectIds[state]];
+        if (subObject && subObject->m_charType == GAFCharacterType::Texture && store.isVisible(state)
+            && subObject->isExternalTransformDirty())
+        {
+            return false;
+        }
+    }
+
+    // The same as realizeFrame does besides applying states, enclosed timelines keep playing
+    for (uint32_t state : m_frameStates)
+    {
+        GAFObject* subObject = m_displayList[objectIds[state]];
+        if (!subObject)
+            continue;
+
+        subObject->m_cursor.updateResetState(allColorMults[state * 4 + GAFColorTransformIndex::GAFCTI_A]);
+
+        if (!store.isVisible(state))
+            continue;
+
+        if (subObject->m_charType == GAFCharacterType::Timeline && !subObject->m_cursor.isInResetState)
+        {
+            subObject->step();
+        }
+
+        subObject->m_lastVisibleInFrame = frameIndex + 1;
+    }
+
+    return true;
+}
+
+bool GAFObject::_isRealizedFrameCurrent() const
+{
+    return m_realizedFrame != IDNONE
+        && m_realizedColor == _displayedColor && m_realizedOpacity == _displayedOpacity
+        && m_realizedCameraMask == getCameraMask()
+        && m_realizedFlippedX == isFlippedX() && m_realizedFlippedY == isFlippedY();
+}
+
+void GAFObject::_setRealizedFrame(uint32_t frameIndex)
+{
+    m_realizedFrame = frameIndex;
+    m_realizedColor = _displayedColor;
+    m_realizedOpacity = _displayedOpacity;
+    m_realizedCameraMask = getCameraMask();
+    m_realizedFlippedX = isFlippedX();
+    m_realizedFlippedY = isFlippedY();
+}
+
+bool GAFObject::_bindEvaluatedNode(GAFObject* node, uint32_t instance)
+{
+    EvaluatedNode& evaluated = m_evaluatedNodes[instance];
+    evaluated.object = node;
+    evaluated.frameIndex = IDNONE;
+    evaluated.isChangeDriven = false;
+
+    m_evaluator->setCursor(instance, &node->m_cursor);
+
+    // Stencils made of timelines are not stepped by the evaluator
+    const AnimationMasks_t& masks = node->m_timeline->getAnimationMasks();
+    for (AnimationMasks_t::const_iterator i = masks.begin(), e = masks.end(); i != e; ++i)
+    {
+        if (std::get<1>(i->second) == GAFCharacterType::Timeline)
+        {
+            return false;
+        }
+    }
+
+    const AnimationObjects_t& objects = node->m_timeline->getAnimationObjects();
+    for (AnimationObjects_t::const_iterator i = objects.begin(), e = objects.end(); i != e; ++i)
+    {
+        if (std::get<1>(i->second) != GAFCharacterType::Timeline)
+        {
+            continue;
+        }
+
+        const uint32_t child = m_evaluator->getChildInstance(instance, i->first);
+        GAFObject* subObject = i->first < node->m_displayList.size() ? node->m_displayList[i->first] : nullptr;
+
+        if (child == IDNONE || !subObject || !_bindEvaluatedNode(subObject, child))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool GAFObject::_isEvaluable(uint32_t framesCount)
+{
+    // Enclosed timelines are evaluated with their top-level object, without catching up every played frame touches nodes
+    if (!m_isEvaluationSupported || !m_timeline || m_timelineParentObject || (framesCount > 1 && !m_isCatchUpEnabled))
+    {
+        return false;
+    }
+
+    if (!m_evaluator)
+    {
+        m_evaluator = new GAFTimelineEvaluator(m_asset, m_timeline);
+        m_evaluator->setTimelinesIncluded(true);
+        m_evaluator->setEventsDeferred(true);
+        m_evaluatedNodes.resize(m_evaluator->getInstancesCount());
+
+        if (!_bindEvaluatedNode(this, 0))
+        {
+            CC_SAFE_DELETE(m_evaluator);
+            m_evaluatedNodes.clear();
+            m_isEvaluationSupported = false;
+            return false;
         }
     }
 
-    GAFAnimationFrame::TimelineActions_t timelineActions = currentFrame->getTimelineActions();
-    for (GAFTimelineAction action : timelineActions)
+    // Delegates are called in the middle of frames, objects that have them are played on the main thread
+    for (EvaluatedNodes_t::const_iterator i = m_evaluatedNodes.begin(), e = m_evaluatedNodes.end(); i != e; ++i)
+    {
+        const GAFObject* object = i->object;
+        if (object->m_sequenceDelegate || object->m_animationFinishedPlayDelegate
+            || object->m_animationStartedNextLoopDelegate || object->m_framePlayedDelegate)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void GAFObject::_evaluate(uint32_t framesCount)
+{
+    // Frames before the last one only advance and perform their actions, as catching up does
+    for (uint32_t i = 0; i < framesCount; ++i)
+    {
+        m_evaluator->step(cocos2d::AffineTransform::IDENTITY, m_evaluatedFrame);
+    }
+}
+
+void GAFObject::_applyEvaluation()
+{
+    m_isEvaluated = false;
+
+    // Nodes the evaluated frame does not realize are left as they are, the same as realizeFrame leaves them
+    for (EvaluatedNodes_t::iterator i = m_evaluatedNodes.begin(), e = m_evaluatedNodes.end(); i != e; ++i)
+    {
+        i->frameIndex = IDNONE;
+    }
+
+    // Decided once the states of the parent node are applied, they may make it apply all of its states
+    auto realize = [this](uint32_t instance)
     {
-        switch (action.getType())
+        EvaluatedNode& node = m_evaluatedNodes[instance];
+        m_evaluator->getFrameStates(instance, node.frameIndex);
+        node.isChangeDriven = node.object->_isRealizedFrameCurrent() && node.object->m_frameStatesIndex == node.object->m_realizedFrame;
+    };
+
+    realize(0);
+
+    // Nested timelines come before their objects
+    for (GAFTimelineEvaluator::Objects_t::const_iterator i = m_evaluatedFrame.begin(), e = m_evaluatedFrame.end(); i != e; ++i)
+    {
+        const EvaluatedNode& node = m_evaluatedNodes[i->instance];
+        GAFObject* object = node.object;
+        GAFObject* subObject = object->m_displayList[i->objectId];
+
+        if (!subObject)
+            continue;
+
+        // States kept in their slots since the realized frame are on the nodes already
+        const GAFAnimationFrame::SubobjectStates_t& realizedStates = object->m_frameStates;
+        const bool isChanged = !node.isChangeDriven || i->slot >= realizedStates.size() || realizedStates[i->slot] != i->state;
+
+        if (i->type == GAFCharacterType::Timeline)
         {
-        case GAFActionType::Stop:
-            pauseAnimation();
-            break;
-        case GAFActionType::Play:
-            resumeAnimation();
-            break;
-        case GAFActionType::GotoAndStop:
-            gotoAndStop(action.getParam(GAFTimelineAction::PI_FRAME));
-            break;
-        case GAFActionType::GotoAndPlay:
-            gotoAndPlay(action.getParam(GAFTimelineAction::PI_FRAME));
-            break;
-        case GAFActionType::DispatchEvent:
+            if (isChanged)
             {
-                std::string type = action.getParam(GAFTimelineAction::PI_EVENT_TYPE);
-                if (type.compare(GAFSoundInfo::SoundEvent) == 0)
-                {
-                    m_asset->soundEvent(&action);
-                }
-                else
-                {
-                    _eventDispatcher->dispatchCustomEvent(action.getParam(GAFTimelineAction::PI_EVENT_TYPE), &action);
-                }
+                object->_applyState(object->m_container, subObject, i->state, i->colorMults, i->colorOffsets);
             }
-            break;
 
-        case GAFActionType::None:
-        default:
-            break;
+            realize(m_evaluator->getChildInstance(i->instance, i->objectId));
         }
+        else if (isChanged || (subObject->m_charType == GAFCharacterType::Texture && subObject->isExternalTransformDirty()))
+        {
+            object->_applyState(object->m_container, subObject, i->state, i->colorMults, i->colorOffsets);
+        }
+
+        subObject->m_lastVisibleInFrame = node.frameIndex + 1;
+    }
+
+    for (uint32_t instance = 0, count = static_cast<uint32_t>(m_evaluatedNodes.size()); instance < count; ++instance)
+    {
+        const EvaluatedNode& node = m_evaluatedNodes[instance];
+        if (node.frameIndex == IDNONE)
+            continue;
+
+        GAFObject* object = node.object;
+        if (object->m_frameStatesIndex != node.frameIndex)
+        {
+            uint32_t frameIndex = IDNONE;
+            object->m_frameStates = m_evaluator->getFrameStates(instance, frameIndex);
+            object->m_frameStatesIndex = frameIndex;
+        }
+
+        object->_setRealizedFrame(node.frameIndex);
     }
+
+    // Events of all evaluated frames are dispatched once the nodes show the last one
+    m_evaluator->dispatchDeferredEvents(_eventDispatcher);
 }
 
 uint32_t GAFObject::getFps() const
@@ -1050,6 +1445,16 @@ void GAFObject::setFpsLimitations(bool fpsLimitations)
     m_skipFpsCheck = !fpsLimitations;
 }
 
+void GAFObject::setCatchUpEnabled(bool value)
+{
+    m_isCatchUpEnabled = value;
+}
+
+bool GAFObject::isCatchUpEnabled() const
+{
+    return m_isCatchUpEnabled;
+}
+
 GAFObject* GAFObject::getObjectByName(const std::string& name)
 {
     if (name.empty())
@@ -1130,6 +1535,11 @@ void GAFObject::visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &transfor
 {
     if (isVisibleInCurrentFrame())
     {
+        if (m_atlasLodEnabled)
+        {
+            _updateAtlasLod();
+        }
+
         GAFSprite::visit(renderer, transform, flags);
     }
 }
@@ -1138,16 +1548,60 @@ void GAFObject::enableTick(bool val)
 {
     if (!m_animationsSelectorScheduled && val)
     {
-        schedule(cocos2d::SEL_SCHEDULE(&GAFObject::processAnimations));
+        GAFAnimationManager::getInstance()->addObject(this, m_animationGroup);
 
         m_animationsSelectorScheduled = true;
     }
     else if (m_animationsSelectorScheduled && !val)
     {
-        unschedule(cocos2d::SEL_SCHEDULE(&GAFObject::processAnimations));
+        GAFAnimationManager::getInstance()->removeObject(this);
 
         m_animationsSelectorScheduled = false;
     }
 }
 
+void GAFObject::setAnimationGroup(int group)
+{
+    if (m_animationGroup == group)
+    {
+        return;
+    }
+
+    if (m_animationsSelectorScheduled)
+    {
+        GAFAnimationManager* manager = GAFAnimationManager::getInstance();
+        manager->removeObject(this);
+        m_animationGroup = group;
+        manager->addObject(this, m_animationGroup);
+    }
+    else
+    {
+        m_animationGroup = group;
+    }
+}
+
+int GAFObject::getAnimationGroup() const
+{
+    return m_animationGroup;
+}
+
+void GAFObject::pause()
+{
+    GAFSprite::pause();
+    m_isTickPaused = true;
+}
+
+void GAFObject::resume()
+{
+    GAFSprite::resume();
+    m_isTickPaused = false;
+}
+
+void GAFObject::cleanup()
+{
+    // Unscheduling everything is what cleanup does to nodes
+    enableTick(false);
+    GAFSprite::cleanup();
+}
+
 NS_GAF_END
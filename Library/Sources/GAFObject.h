@@ -4,6 +4,9 @@
 #include "GAFSprite.h"
 #include "GAFCollections.h"
 #include "GAFTextureAtlas.h"
+#include "GAFAnimationFrame.h"
+#include "GAFTimelineCursor.h"
+#include "GAFTimelineEvaluator.h"
 
 NS_GAF_BEGIN
 
@@ -12,6 +15,8 @@ class GAFTimeline;
 
 class GAFObject : public GAFSprite
 {
+    friend class GAFAnimationManager;
+
 private:
     cocos2d::AffineTransform GAF_CGAffineTransformCocosFormatFromFlashFormat(cocos2d::AffineTransform aTransform);
 
@@ -28,24 +33,57 @@ private:
     cocos2d::Node*                          m_container;
 
     uint32_t                                m_totalFrameCount;
-    uint32_t                                m_currentSequenceStart;
-    uint32_t                                m_currentSequenceEnd;
-
-    bool                                    m_isRunning;
-    bool                                    m_isLooped;
-    bool                                    m_isReversed;
 
-    double                                  m_timeDelta;
     uint32_t                                m_fps;
     bool                                    m_skipFpsCheck;
+    bool                                    m_isCatchUpEnabled;
+    bool                                    m_isCatchingUp; // Frames are advanced without touching nodes
 
     bool                                    m_animationsSelectorScheduled;
+    int                                     m_animationGroup;
+    size_t                                  m_animationIndex; // In the group of GAFAnimationManager
+    bool                                    m_isTickPaused;
+    bool                                    m_isEvaluated; // Frames of the update are evaluated, the manager applies them in the object's turn
+
+    // Node of an evaluator instance and how the evaluated frame is applied to it
+    struct EvaluatedNode
+    {
+        GAFObject*  object;
+        uint32_t    frameIndex;     // Evaluated, IDNONE if the frame does not realize the node
+        bool        isChangeDriven; // Only states that differ from the ones of the realized frame are applied
+    };
+    typedef std::vector<EvaluatedNode> EvaluatedNodes_t;
 
-    bool                                    m_isInResetState;
+    GAFTimelineEvaluator*                   m_evaluator; // Steps the object off the main thread with the cursors of its nodes
+    EvaluatedNodes_t                        m_evaluatedNodes; // By evaluator instance
+    GAFTimelineEvaluator::Objects_t         m_evaluatedFrame;
+    bool                                    m_isEvaluationSupported;
+
+    bool                                    m_atlasLodEnabled;
+    float                                   m_atlasLodScale; // Atlas scale objects show, 0 for the loaded atlases
 
 private:
     void constructObject();
     GAFObject* _instantiateObject(uint32_t id, GAFCharacterType type, uint32_t reference, bool isMask);
+    void _setObjectAtlasScale(uint32_t id, GAFCharacterType type, uint32_t reference, float scale);
+    void _updateAtlasLod();
+    /// Realizes a frame whose states are the same as the ones of the realized frame, nodes are left as they are.
+    /// @returns false without doing anything if states of the frame still have to be applied
+    bool _realizeStaticFrame(uint32_t frameIndex);
+    /// Nodes show m_realizedFrame the way the current color, opacity, camera mask and flipping make them look
+    bool _isRealizedFrameCurrent() const;
+    void _setRealizedFrame(uint32_t frameIndex);
+    /// Applies the state to the subobject placed in out, colors are the state ones combined with the parent ones
+    void _applyState(cocos2d::Node* out, GAFObject* subObject, uint32_t state, const float* colorMults, const float* colorOffsets);
+
+    /// Binds nodes of the object to the instances of the evaluator, false if a node has no instance
+    bool _bindEvaluatedNode(GAFObject* node, uint32_t instance);
+    /// Whether _evaluate may play the frames instead of processAnimations, called on the main thread
+    bool _isEvaluable(uint32_t framesCount);
+    /// Advances the object and its enclosed timelines by the frames, no node is touched so any thread may call it
+    void _evaluate(uint32_t framesCount);
+    /// Applies the last evaluated frame to the nodes and dispatches the events of the evaluated frames
+    void _applyEvaluation();
 
 protected:
     GAFObject*                              m_timelineParentObject;
@@ -55,16 +93,23 @@ protected:
     MaskList_t                              m_masks;
     GAFCharacterType                        m_charType;
     GAFObjectType                           m_objectType;
-    uint32_t                                m_currentFrame;
-    uint32_t                                m_showingFrame; // Frame number that is valid from the beginning of realize frame
+    GAFTimelineCursor                       m_cursor;
     uint32_t                                m_lastVisibleInFrame; // Last frame that object was visible in
     Filters_t                               m_parentFilters;
+    GAFAnimationFrame::SubobjectStates_t    m_frameStates; // States of m_frameStatesIndex frame, owned by the timeline
+    uint32_t                                m_frameStatesIndex;
+    uint32_t                                m_realizedFrame; // Frame the display list shows, IDNONE makes realizeFrame apply every state
+    cocos2d::Color3B                        m_realizedColor; // Inputs the frame was realized with, when they change every state is applied too
+    GLubyte                                 m_realizedOpacity;
+    unsigned short                          m_realizedCameraMask;
+    bool                                    m_realizedFlippedX;
+    bool                                    m_realizedFlippedY;
     cocos2d::Vec4                           m_parentColorTransforms[2];
 
     void    setTimelineParentObject(GAFObject* obj) { m_timelineParentObject = obj; }
 
     void    processAnimation();
-    void    processAnimations(float dt);
+    void    processAnimations(uint32_t framesCount);
 
     void    instantiateObject(const AnimationObjects_t& objs, const AnimationMasks_t& masks);
 
@@ -157,10 +202,18 @@ public:
     /// Stops playing an animation as a sequence
     void        clearSequence();
 
-    /// schedule/unschedule
+    /// Adds to/removes from GAFAnimationManager
     /// @note this function is automatically called in start/stop
     void        enableTick(bool val);
 
+    /// Group of GAFAnimationManager the object is advanced in, 0 by default
+    void        setAnimationGroup(int group);
+    int         getAnimationGroup() const;
+
+    void        pause() override;
+    void        resume() override;
+    void        cleanup() override;
+
     void        setAnimationRunning(bool value, bool recurcive);
 public:
 
@@ -202,6 +255,22 @@ public:
     void setFps(uint32_t value);
 
     void setFpsLimitations(bool fpsLimitations);
+
+    /// After a long frame the missed animation frames only advance and perform their actions and delegates,
+    /// states are applied to nodes for the last of them. Default is GAF_ENABLE_CATCH_UP
+    void setCatchUpEnabled(bool value);
+    bool isCatchUpEnabled() const;
+
+    /// Switches the object and its enclosed timelines to the atlas scale that matches their on-screen scale
+    /// every time it changes. Atlases of other scales are loaded on demand. Disabled by default
+    /// @note textures no object shows anymore are kept till GAFAsset::releaseUnusedTextures
+    void setAtlasLodEnabled(bool value);
+    bool isAtlasLodEnabled() const;
+
+    /// Shows atlases with the smallest scale not below the given one in the object and its enclosed timelines
+    void setAtlasLodScale(float scale);
+    /// Scale atlases were chosen for by setAtlasLodScale, 0 if the loaded ones are shown
+    float getAtlasLodScale() const;
 };
 
 NS_GAF_END
\ No newline at end of file
@@ -19,6 +19,7 @@ GAFSprite::GAFSprite()
 : objectIdRef(IDNONE)
 , m_useSeparateBlendFunc(false)
 , m_isLocator(false)
+, m_isExternalTransformDirty(true)
 , m_blendEquation(-1)
 , m_atlasScale(1.0f)
 , m_externalTransform(AffineTransform::IDENTITY)
@@ -48,6 +49,14 @@ bool GAFSprite::initWithSpriteFrame(cocos2d::SpriteFrame *spriteFrame)
     return bRet;
 }
 
+void GAFSprite::replaceSpriteFrame(cocos2d::SpriteFrame *spriteFrame, GAFRotation rotation)
+{
+    CCASSERT(spriteFrame != nullptr, "");
+
+    m_rotation = rotation;
+    setSpriteFrame(spriteFrame);
+}
+
 bool GAFSprite::initWithTexture(cocos2d::Texture2D *pTexture, const cocos2d::Rect& rect, bool rotated)
 {
     if (cocos2d::Sprite::initWithTexture(pTexture, rect, rotated))
@@ -209,6 +218,7 @@ void GAFSprite::setExternalTransform(const cocos2d::AffineTransform& transform)
         _transformDirty = true;
         _inverseDirty = true;
     }
+    m_isExternalTransformDirty = false;
 }
 
 const cocos2d::AffineTransform& GAFSprite::getExternalTransform() const
@@ -216,6 +226,42 @@ const cocos2d::AffineTransform& GAFSprite::getExternalTransform() const
     return m_externalTransform;
 }
 
+void GAFSprite::setPosition(const cocos2d::Vec2& position)
+{
+    cocos2d::Sprite::setPosition(position);
+    m_isExternalTransformDirty = true;
+}
+
+void GAFSprite::setPosition(float x, float y)
+{
+    cocos2d::Sprite::setPosition(x, y);
+    m_isExternalTransformDirty = true;
+}
+
+void GAFSprite::setScale(float scale)
+{
+    cocos2d::Sprite::setScale(scale);
+    m_isExternalTransformDirty = true;
+}
+
+void GAFSprite::setScale(float scaleX, float scaleY)
+{
+    cocos2d::Sprite::setScale(scaleX, scaleY);
+    m_isExternalTransformDirty = true;
+}
+
+void GAFSprite::setScaleX(float scaleX)
+{
+    cocos2d::Sprite::setScaleX(scaleX);
+    m_isExternalTransformDirty = true;
+}
+
+void GAFSprite::setScaleY(float scaleY)
+{
+    cocos2d::Sprite::setScaleY(scaleY);
+    m_isExternalTransformDirty = true;
+}
+
 const cocos2d::Mat4& GAFSprite::getNodeToParentTransform() const
 {
     if (_transformDirty)
@@ -28,6 +28,9 @@ public:
     GAFSprite();
 
     bool initWithSpriteFrame(cocos2d::SpriteFrame *spriteFrame, GAFRotation rotation);
+    /// Shows the frame instead of the current one keeping the rest of the sprite state,
+    /// used to switch to an atlas of another scale
+    virtual void replaceSpriteFrame(cocos2d::SpriteFrame *spriteFrame, GAFRotation rotation);
     virtual bool initWithSpriteFrame(cocos2d::SpriteFrame *spriteFrame) override;
     virtual bool initWithTexture(cocos2d::Texture2D *pTexture, const cocos2d::Rect& rect, bool rotated) override;
     void setTexture(cocos2d::Texture2D *texture) override;
@@ -39,6 +42,17 @@ public:
     void setExternalTransform(const cocos2d::AffineTransform& transform);
     const cocos2d::AffineTransform& getExternalTransform() const;
 
+    /// Position and scale are folded in the external transform by GAFObject,
+    /// changing them makes it dirty till the external transform is set again
+    inline bool isExternalTransformDirty() const { return m_isExternalTransformDirty; }
+
+    virtual void setPosition(const cocos2d::Vec2& position) override;
+    virtual void setPosition(float x, float y) override;
+    virtual void setScale(float scale) override;
+    virtual void setScale(float scaleX, float scaleY) override;
+    virtual void setScaleX(float scaleX) override;
+    virtual void setScaleY(float scaleY) override;
+
     virtual const cocos2d::Mat4& getNodeToParentTransform() const override;
     virtual cocos2d::AffineTransform getNodeToParentAffineTransform() const override;
 #if COCOS2D_VERSION < 0x00030200
@@ -99,6 +113,7 @@ private:
 
     float                   m_atlasScale;
     bool                    m_isLocator;
+    bool                    m_isExternalTransformDirty;
 
     /* Never used */
     gafBlendFuncSeparate    m_blendFuncSeparate;
@@ -0,0 +1,136 @@
+#include "GAFPrecompiled.h"
+#include "GAFStateStore.h"
+#include "GAFSubobjectState.h"
+
+#include "../external/xxhash/xxhash.h"
+
+NS_GAF_BEGIN
+
+bool GAFStateStore::StateRecord::operator==(const StateRecord& other) const
+{
+    return size == other.size && memcmp(data, other.data, size) == 0;
+}
+
+size_t GAFStateStore::StateRecordHash::operator()(const StateRecord& record) const
+{
+    return XXH32(record.data, record.size, 0);
+}
+
+GAFStateStore::GAFStateStore()
+: m_internedHits(0)
+{
+    m_filters.push_back(Filters_t());
+}
+
+GAFStateStore::~GAFStateStore()
+{
+    // Filters are owned by the asset arena
+}
+
+uint32_t GAFStateStore::pushState(const GAFSubobjectState& state)
+{
+    const uint32_t index = static_cast<uint32_t>(m_objectIds.size());
+
+    m_objectIds.push_back(state.objectIdRef);
+    m_maskObjectIds.push_back(state.maskObjectIdRef);
+    m_zIndices.push_back(state.zIndex);
+    m_transforms.push_back(state.affineTransform);
+    m_colorMults.insert(m_colorMults.end(), state.colorMults(), state.colorMults() + 4);
+    m_colorOffsets.insert(m_colorOffsets.end(), state.colorOffsets(), state.colorOffsets() + 4);
+
+    if (state.getFilters().empty())
+    {
+        m_filterLists.push_back(0);
+    }
+    else
+    {
+        std::pair<InternedFilterLists_t::iterator, bool> list = m_internedFilterLists.insert(std::make_pair(state.getFilters(), static_cast<uint32_t>(m_filters.size())));
+        if (list.second)
+        {
+            m_filters.push_back(state.getFilters());
+        }
+        m_filterLists.push_back(list.first->second);
+    }
+
+    return index;
+}
+
+uint32_t GAFStateStore::pushEmptyState(uint32_t objectId)
+{
+    GAFSubobjectState state;
+    state.initEmpty(objectId);
+    return pushState(state);
+}
+
+uint32_t GAFStateStore::findInterned(const unsigned char* record, unsigned int size)
+{
+    StateRecord key = { record, size };
+    InternedStates_t::const_iterator it = m_internedStates.find(key);
+    if (it == m_internedStates.end())
+        return IDNONE;
+
+    ++m_internedHits;
+    return it->second;
+}
+
+void GAFStateStore::intern(const unsigned char* record, unsigned int size, uint32_t state)
+{
+    StateRecord key = { record, size };
+    m_internedStates[key] = state;
+}
+
+void GAFStateStore::endLoading()
+{
+    InternedStates_t().swap(m_internedStates);
+    InternedFilterLists_t().swap(m_internedFilterLists);
+
+    m_objectIds.shrink_to_fit();
+    m_maskObjectIds.shrink_to_fit();
+    m_zIndices.shrink_to_fit();
+    m_transforms.shrink_to_fit();
+    m_colorMults.shrink_to_fit();
+    m_colorOffsets.shrink_to_fit();
+    m_filterLists.shrink_to_fit();
+    m_filters.shrink_to_fit();
+}
+
+size_t GAFStateStore::getMemorySize() const
+{
+    size_t size = m_objectIds.capacity() * sizeof(uint32_t)
+        + m_maskObjectIds.capacity() * sizeof(uint32_t)
+        + m_zIndices.capacity() * sizeof(int)
+        + m_transforms.capacity() * sizeof(cocos2d::AffineTransform)
+        + m_colorMults.capacity() * sizeof(float)
+        + m_colorOffsets.capacity() * sizeof(float)
+        + m_filterLists.capacity() * sizeof(uint32_t)
+        + m_filters.capacity() * sizeof(Filters_t);
+
+    for (const Filters_t& filters : m_filters)
+    {
+        size += filters.capacity() * sizeof(GAFFilterData*);
+    }
+
+    return size;
+}
+
+void GAFStateStore::assign(size_t count, const uint32_t* objectIds, const uint32_t* maskObjectIds, const int* zIndices,
+                           const cocos2d::AffineTransform* transforms, const float* colorMults, const float* colorOffsets,
+                           const uint32_t* filterLists)
+{
+    m_objectIds.assign(objectIds, objectIds + count);
+    m_maskObjectIds.assign(maskObjectIds, maskObjectIds + count);
+    m_zIndices.assign(zIndices, zIndices + count);
+    m_transforms.assign(transforms, transforms + count);
+    m_colorMults.assign(colorMults, colorMults + count * 4);
+    m_colorOffsets.assign(colorOffsets, colorOffsets + count * 4);
+    m_filterLists.assign(filterLists, filterLists + count);
+
+    m_filters.resize(1);
+}
+
+void GAFStateStore::pushFilterList(const Filters_t& filters)
+{
+    m_filters.push_back(filters);
+}
+
+NS_GAF_END
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "GAFCollections.h"
+
+NS_GAF_BEGIN
+
+class GAFSubobjectState;
+
+/// Object states of a timeline kept as a structure of arrays.
+/// States are addressed by the index returned from pushState, animation frames refer to them by these indices
+class GAFStateStore
+{
+public:
+    typedef std::vector<uint32_t> StateIndices_t;
+
+private:
+    typedef std::vector<Filters_t> FilterLists_t;
+
+    // Binary state record as it is stored in the GAF file
+    struct StateRecord
+    {
+        const unsigned char*    data;
+        unsigned int            size;
+
+        bool operator==(const StateRecord& other) const;
+    };
+
+    struct StateRecordHash
+    {
+        size_t operator()(const StateRecord& record) const;
+    };
+
+    typedef std::unordered_map<StateRecord, uint32_t, StateRecordHash> InternedStates_t;
+    typedef std::map<Filters_t, uint32_t> InternedFilterLists_t;
+
+    std::vector<uint32_t>                   m_objectIds;
+    std::vector<uint32_t>                   m_maskObjectIds;
+    std::vector<int>                        m_zIndices;
+    std::vector<cocos2d::AffineTransform>   m_transforms;
+    std::vector<float>                      m_colorMults;   // 4 per state
+    std::vector<float>                      m_colorOffsets; // 4 per state
+    std::vector<uint32_t>                   m_filterLists;  // index in m_filters, 0 - no filters
+
+    FilterLists_t                           m_filters;
+
+    InternedStates_t                        m_internedStates; // Load time only, records point into the file data
+    InternedFilterLists_t                   m_internedFilterLists; // Load time only, pooled filters make equal lists share one
+    size_t                                  m_internedHits;
+
+public:
+    GAFStateStore();
+    ~GAFStateStore();
+
+    /// Appends the state, filters are shared with it. States with the same filters share one filter list
+    /// @returns index of the stored state
+    uint32_t                pushState(const GAFSubobjectState& state);
+    /// Appends an invisible state with identity transform
+    uint32_t                pushEmptyState(uint32_t objectId);
+
+    /// Looks for a state loaded from an identical record
+    /// @returns index of the state or IDNONE
+    uint32_t                findInterned(const unsigned char* record, unsigned int size);
+    /// Makes the state reusable for identical records. Record data must stay valid until endLoading
+    void                    intern(const unsigned char* record, unsigned int size, uint32_t state);
+
+    /// Drops the interning table and releases excess capacity once the timeline is loaded
+    void                    endLoading();
+
+    /// Replaces all states with copies of the given arrays, color arrays hold 4 values per state.
+    /// Filter lists the states refer to are pushed separately
+    void                    assign(size_t count, const uint32_t* objectIds, const uint32_t* maskObjectIds, const int* zIndices,
+                                   const cocos2d::AffineTransform* transforms, const float* colorMults, const float* colorOffsets,
+                                   const uint32_t* filterLists);
+    /// Appends a list of filters that states refer to by its index. Filters are shared with it
+    void                    pushFilterList(const Filters_t& filters);
+
+    size_t                  size() const { return m_objectIds.size(); }
+    /// Number of loaded states that were replaced with already stored identical ones
+    size_t                  getInternedCount() const { return m_internedHits; }
+    /// Bytes taken by the state arrays, filters themselves are in the asset arena
+    size_t                  getMemorySize() const;
+
+    const uint32_t*                 getObjectIds() const { return m_objectIds.data(); }
+    const uint32_t*                 getMaskObjectIds() const { return m_maskObjectIds.data(); }
+    const int*                      getZIndices() const { return m_zIndices.data(); }
+    const cocos2d::AffineTransform* getTransforms() const { return m_transforms.data(); }
+    const float*                    getColorMults() const { return m_colorMults.data(); }
+    const float*                    getColorOffsets() const { return m_colorOffsets.data(); }
+    const uint32_t*                 getFilterLists() const { return m_filterLists.data(); }
+
+    /// Number of filter lists including the empty one with index 0
+    size_t                  getFilterListsCount() const { return m_filters.size(); }
+    const Filters_t&        getFilterList(uint32_t list) const { return m_filters[list]; }
+
+    const Filters_t&        getFilters(uint32_t state) const { return m_filters[m_filterLists[state]]; }
+
+    inline bool isVisible(uint32_t state) const
+    {
+        return (m_colorMults[state * 4 + 3] > std::numeric_limits<float>::epsilon()) || (m_colorOffsets[state * 4 + 3] > std::numeric_limits<float>::epsilon());
+    }
+};
+
+NS_GAF_END
\ No newline at end of file
@@ -6,8 +6,10 @@ NS_GAF_BEGIN
 
 GAFStream::GAFStream(GAFFile* input):
 m_input(input),
-m_currentByte(0),
-m_unusedBits(0)
+m_arena(nullptr),
+m_filterPool(nullptr),
+m_bitBuffer(0),
+m_bitCount(0)
 {
     assert(input);
 }
@@ -16,13 +18,6 @@ GAFStream::~GAFStream()
 {
 }
 
-void GAFStream::readNBytesOfT(void* dest, unsigned int n)
-{
-    align();
-
-    m_input->readBytes(dest, n);
-}
-
 bool GAFStream::readBool()
 {
     return readUint(1) ? true : false;
@@ -35,39 +30,39 @@ unsigned int GAFStream::readUint(unsigned short bitcount)
 {
     assert(bitcount <= 32);
 
-    unsigned int retval = 0;
+    if (bitcount == 0)
+        return 0;
 
-    while (bitcount)
+    if (m_bitCount < bitcount)
     {
-        if (m_unusedBits)
-        {
-            if (bitcount >= m_unusedBits)
-            {
-                retval |= (m_currentByte << (bitcount - m_unusedBits));
-                bitcount -= m_unusedBits;
-
-                m_currentByte = 0;
-                m_unusedBits = 0;
-            }
-            else
-            {
-                retval |= (m_currentByte >> (m_unusedBits - bitcount));
-                m_currentByte &= ((1 << (m_unusedBits - bitcount)) - 1);
-                m_unusedBits -= bitcount;
-
-                bitcount = 0;
-            }
-        }
-        else
-        {
-            m_currentByte = m_input->read1Byte();
-            m_unusedBits = 8;
-        }
+        _refillBits();
     }
 
-    assert(bitcount == 0);
+    assert(m_bitCount >= bitcount);
 
-    return retval;
+    m_bitCount -= bitcount;
+    return static_cast<unsigned int>((m_bitBuffer >> m_bitCount) & ((1ull << bitcount) - 1));
+}
+
+// Tops up the bit buffer with as many whole bytes as fit in it
+void GAFStream::_refillBits()
+{
+    const unsigned int position = m_input->getPosition();
+    const unsigned long available = m_input->getDataLength() - position;
+
+    unsigned int count = (64 - m_bitCount) / 8;
+    if (count > available)
+    {
+        count = static_cast<unsigned int>(available);
+    }
+
+    const unsigned char* bytes = m_input->readBytesInplace(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        m_bitBuffer = (m_bitBuffer << 8) | bytes[i];
+    }
+
+    m_bitCount += count * 8;
 }
 
 // Reads a bit-packed little-endian signed integer
@@ -89,50 +84,35 @@ int GAFStream::readSint(unsigned short bitcount)
 
 float GAFStream::readFixed()
 {
+    align();
     int retval = m_input->read4Bytes();
     return static_cast<float>(retval / 65536.0f);
 }
 
 float GAFStream::readFixed8()
 {
+    align();
     short retval = m_input->read2Bytes();
     return static_cast<float>(retval / 255.0f);
 }
 
-unsigned char GAFStream::readUByte()
+void GAFStream::readString(std::string* out)
 {
     align();
-    return m_input->read1Byte();
+    m_input->readString(out);
 }
 
-char GAFStream::readSByte()
+const unsigned char* GAFStream::readBytesInplace(unsigned int len)
 {
     align();
-    return m_input->read1Byte();
-}
 
-unsigned short GAFStream::readU16()
-{
-    unsigned short retval = 0;
-    readNBytesOfT(&retval, sizeof(unsigned short));
-    return retval;
-}
-
-unsigned int GAFStream::readU32()
-{
-    align();
-    return m_input->read4Bytes();
+    return m_input->readBytesInplace(len);
 }
 
-int GAFStream::readS32()
+unsigned short GAFStream::readStringInplace(const char** out)
 {
     align();
-    return static_cast<int>(m_input->read4Bytes());
-}
-
-void GAFStream::readString(std::string* out)
-{
-    m_input->readString(out);
+    return m_input->readStringInplace(out);
 }
 
 GAFFile* GAFStream::getInput() const
@@ -148,10 +128,33 @@ Tags::Enum GAFStream::openTag()
     int tagType = tagHeader >> 6;
     unsigned int tagLenght = tagHeader & 0x3F;*/
 
+    // Tag contents are read without further bounds checks, so the whole tag has to be inside the data.
+    // A truncated tag is reported as the end of the stream
+    const unsigned long dataLength = m_input->getDataLength();
+    const unsigned long long headerEnd = static_cast<unsigned long long>(m_input->getPosition()) + sizeof(uint16_t) + sizeof(uint32_t);
+
+    if (headerEnd > dataLength)
+    {
+        CCLOGERROR("Unexpected end of GAF data at [%u]", m_input->getPosition());
+
+        m_input->rewind(static_cast<unsigned int>(dataLength));
+        TagRecord record = { static_cast<unsigned int>(dataLength), 0, Tags::TagEnd };
+        m_tagStack.push(record);
+        return Tags::TagEnd;
+    }
+
     unsigned short tagType = readU16();
     unsigned int tagLenght = readU32();
 
-    assert(m_unusedBits == 0);
+    if (headerEnd + tagLenght > dataLength)
+    {
+        CCLOGERROR("Tag [%s] of length [%u] exceeds GAF data", Tags::toString((Tags::Enum)tagType).c_str(), tagLenght);
+
+        m_input->rewind(static_cast<unsigned int>(dataLength));
+        TagRecord record = { static_cast<unsigned int>(dataLength), 0, Tags::TagEnd };
+        m_tagStack.push(record);
+        return Tags::TagEnd;
+    }
 
     //BFORMATTED_GLOG(DLOG(INFO) << boost::format("[%d]: Opening tag: [%s] with len: [%d] expected stream position: [%d]") % getPosition() % Tags::toString((Tags::Enum)tagType) % tagLenght % (getPosition() + tagLenght));
 
@@ -172,7 +175,7 @@ void GAFStream::closeTag()
 
     m_tagStack.pop();
 
-    const uint32_t inputPosition = m_input->getPosition();
+    const uint32_t inputPosition = getPosition();
 
     if (record.expectedStreamPos != inputPosition)
     {
@@ -183,7 +186,17 @@ void GAFStream::closeTag()
 
     m_input->rewind(record.expectedStreamPos);
 
-    m_unusedBits = 0;
+    m_bitCount = 0;
+}
+
+void GAFStream::skipTag()
+{
+    assert(!m_tagStack.empty());
+
+    m_input->rewind(m_tagStack.top().expectedStreamPos);
+    m_tagStack.pop();
+
+    m_bitCount = 0;
 }
 
 unsigned int GAFStream::getTagLenghtOnStackTop() const
@@ -202,23 +215,13 @@ unsigned int GAFStream::getTagExpectedPosition() const
 
 unsigned int GAFStream::getPosition() const
 {
-    return m_input->getPosition();
-}
-
-void GAFStream::align()
-{
-    m_currentByte = 0;
-    m_unusedBits = 0;
+    // Whole bytes in the bit buffer are not read yet
+    return m_input->getPosition() - m_bitCount / 8;
 }
 
 bool GAFStream::isEndOfStream() const
 {
-    return m_input->isEOF();
-}
-
-float GAFStream::readFloat()
-{
-    return m_input->readFloat();
+    return m_input->isEOF() && m_bitCount < 8;
 }
 
 NS_GAF_END
\ No newline at end of file
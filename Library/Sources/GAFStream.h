@@ -1,17 +1,21 @@
 #pragma once
 
 #include "TagDefines.h"
+#include "GAFFile.h"
 
 NS_GAF_BEGIN
 
-class GAFFile;
+class GAFArena;
+class GAFFilterPool;
 
 class GAFStream
 {
 private:
     GAFFile*            m_input;
-    unsigned char       m_currentByte;
-    unsigned char       m_unusedBits;
+    GAFArena*           m_arena;
+    GAFFilterPool*      m_filterPool;
+    unsigned long long  m_bitBuffer;    // Bits read ahead from the input, the oldest are the most significant
+    unsigned int        m_bitCount;     // Number of unread bits in m_bitBuffer
 
     struct TagRecord
     {
@@ -23,6 +27,8 @@ private:
     typedef std::stack<TagRecord> TagStack_t;
     TagStack_t          m_tagStack;
 
+    void                 _refillBits();
+
 public:
     GAFStream(GAFFile* input);
     ~GAFStream();
@@ -35,6 +41,8 @@ public:
     float                readFixed8();
 
     float                readFloat();
+    /// Reads count consecutive floats
+    void                 readFloats(float* dest, unsigned int count);
 
     unsigned char        readUByte();
     char                 readSByte();
@@ -47,10 +55,22 @@ public:
 
     void                 readString(std::string* out);
 
+    // Zero-copy readers. Returned pointers point into the input buffer and stay valid while it is opened
+    const unsigned char* readBytesInplace(unsigned int len);
+    unsigned short       readStringInplace(const char** out);
+
     GAFFile*             getInput() const;
 
+    /// Allocator for the objects created while reading this stream
+    void                 setArena(GAFArena* arena) { m_arena = arena; }
+    GAFArena*            getArena() const { return m_arena; }
+    /// Filters read from this stream are shared through the pool, none if it is not set
+    void                 setFilterPool(GAFFilterPool* pool) { m_filterPool = pool; }
+    GAFFilterPool*       getFilterPool() const { return m_filterPool; }
+
     Tags::Enum           openTag();
     void                 closeTag();
+    void                 skipTag(); // closes tag on the top of the stack without reading its contents
     unsigned int         getTagLenghtOnStackTop() const;
     unsigned int         getTagExpectedPosition() const;
     unsigned int         getPosition() const;
@@ -60,4 +80,64 @@ public:
     bool                 isEndOfStream() const;
 };
 
+// Byte aligned reads are on the hot path of every tag reader, keep them inlined
+
+inline void GAFStream::align()
+{
+    if (m_bitCount)
+    {
+        // Whole bytes that were read ahead go back to the input, the partially read byte is skipped
+        m_input->rewind(m_input->getPosition() - m_bitCount / 8);
+        m_bitCount = 0;
+    }
+}
+
+inline void GAFStream::readNBytesOfT(void* dest, unsigned int n)
+{
+    align();
+
+    m_input->readBytes(dest, n);
+}
+
+inline void GAFStream::readFloats(float* dest, unsigned int count)
+{
+    readNBytesOfT(dest, count * sizeof(float));
+}
+
+inline float GAFStream::readFloat()
+{
+    align();
+    return m_input->readFloat();
+}
+
+inline unsigned char GAFStream::readUByte()
+{
+    align();
+    return m_input->read1Byte();
+}
+
+inline char GAFStream::readSByte()
+{
+    align();
+    return m_input->read1Byte();
+}
+
+inline unsigned short GAFStream::readU16()
+{
+    align();
+    return m_input->read2Bytes();
+}
+
+inline unsigned int GAFStream::readU32()
+{
+    align();
+    return m_input->read4Bytes();
+}
+
+inline int GAFStream::readS32()
+{
+    align();
+    return static_cast<int>(m_input->read4Bytes());
+}
+
 NS_GAF_END
\ No newline at end of file
@@ -12,12 +12,11 @@ GAFSubobjectState::GAFSubobjectState()
 objectIdRef(IDNONE),
 maskObjectIdRef(IDNONE)
 {
-    m_refCount = 1;
 }
 
 GAFSubobjectState::~GAFSubobjectState()
 {
-    GAF_RELEASE_ARRAY(Filters_t, m_filters);
+    // Filters are owned by the asset arena
 }
 
 bool GAFSubobjectState::initEmpty(unsigned int ref)
@@ -46,19 +45,4 @@ const Filters_t& GAFSubobjectState::getFilters() const
     return m_filters;
 }
 
-void GAFSubobjectState::addRef()
-{
-    m_refCount++;
-}
-
-void GAFSubobjectState::release()
-{
-    --m_refCount;
-
-    if (0 == m_refCount)
-    {
-        delete this;
-    }
-}
-
 NS_GAF_END
\ No newline at end of file
@@ -12,6 +12,7 @@ enum GAFColorTransformIndex
     GAFCTI_A
 };
 
+/// Object state as it is read from the animation frames tag, see GAFStateStore for the runtime storage
 class GAFSubobjectState
 {
 private:
@@ -19,8 +20,6 @@ private:
     float           _colorMults[4];
     float           _colorOffsets[4];
 
-    unsigned long   m_refCount;
-
 public:
 
     unsigned int objectIdRef;
@@ -63,10 +62,6 @@ public:
     void                pushFilter(GAFFilterData* filter);
     const Filters_t&    getFilters() const;
 
-
-    void                addRef();
-    void                release();
-
 }; // GAFSubobjectState
 
 NS_GAF_END
\ No newline at end of file
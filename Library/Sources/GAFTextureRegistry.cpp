@@ -0,0 +1,74 @@
+#include "GAFPrecompiled.h"
+#include "GAFTextureRegistry.h"
+
+NS_GAF_BEGIN
+
+GAFTextureRegistry* GAFTextureRegistry::s_instance = nullptr;
+
+GAFTextureRegistry* GAFTextureRegistry::getInstance()
+{
+    if (!s_instance)
+    {
+        s_instance = new GAFTextureRegistry();
+    }
+    return s_instance;
+}
+
+bool GAFTextureRegistry::hasTexture(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_entries.find(path) != m_entries.end();
+}
+
+cocos2d::Texture2D* GAFTextureRegistry::acquireTexture(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Entries_t::iterator it = m_entries.find(path);
+    if (it == m_entries.end())
+    {
+        return nullptr;
+    }
+
+    ++it->second.users;
+    return it->second.texture;
+}
+
+void GAFTextureRegistry::addTexture(const std::string& path, cocos2d::Texture2D* texture)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    assert(m_entries.find(path) == m_entries.end());
+
+    texture->retain();
+
+    Entry entry = { texture, 1 };
+    m_entries[path] = entry;
+}
+
+void GAFTextureRegistry::releaseTexture(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Entries_t::iterator it = m_entries.find(path);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    if (--it->second.users == 0)
+    {
+        it->second.texture->release();
+        m_entries.erase(it);
+    }
+}
+
+size_t GAFTextureRegistry::getTexturesCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_entries.size();
+}
+
+NS_GAF_END
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "GAFMacros.h"
+
+#include <mutex>
+#include <unordered_map>
+
+NS_GAF_BEGIN
+
+/// Textures shared by all assets, keyed by resolved image path. Bundle entries are keyed by the bundle path and the entry path.
+/// Assets exported from the same atlas images use the same textures instead of decoding and uploading
+/// their own copies. Every user acquires a texture and releases it when it is done, the texture is dropped
+/// from the registry with its last user
+class GAFTextureRegistry
+{
+private:
+    struct Entry
+    {
+        cocos2d::Texture2D* texture;
+        size_t              users;
+    };
+
+    typedef std::unordered_map<std::string, Entry> Entries_t;
+
+    Entries_t               m_entries;
+    mutable std::mutex      m_mutex;
+
+    static GAFTextureRegistry* s_instance;
+
+    GAFTextureRegistry() {}
+
+public:
+    static GAFTextureRegistry* getInstance();
+
+    /// Tells whether a texture of the image is registered now. Thread safe, used to skip decoding of shared images
+    bool                    hasTexture(const std::string& path) const;
+
+    /// Returns the texture of the image and counts the caller as its user or nullptr if there is none
+    /// @note textures are used on the main thread only
+    cocos2d::Texture2D*     acquireTexture(const std::string& path);
+    /// Registers a texture made from the image, the caller is its first user
+    void                    addTexture(const std::string& path, cocos2d::Texture2D* texture);
+    /// The texture is released when its last user releases it
+    void                    releaseTexture(const std::string& path);
+
+    size_t                  getTexturesCount() const;
+};
+
+NS_GAF_END
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "GAFPrecompiled.h"
+#include "GAFTextureUploadScheduler.h"
+#include "GAFAssetTextureManager.h"
+
+#include <chrono>
+
+NS_GAF_BEGIN
+
+static const char* const s_scheduleKey = "GAFTextureUploadScheduler";
+
+GAFTextureUploadScheduler* GAFTextureUploadScheduler::s_instance = nullptr;
+
+GAFTextureUploadScheduler::GAFTextureUploadScheduler()
+: m_frameBudget(GAF_TEXTURE_UPLOAD_BUDGET)
+, m_isScheduled(false)
+{
+}
+
+GAFTextureUploadScheduler::~GAFTextureUploadScheduler()
+{
+    _setScheduled(false);
+
+    for (Jobs_t::iterator i = m_jobs.begin(), e = m_jobs.end(); i != e; ++i)
+    {
+        i->manager->release();
+    }
+}
+
+GAFTextureUploadScheduler* GAFTextureUploadScheduler::getInstance()
+{
+    if (!s_instance)
+    {
+        s_instance = new GAFTextureUploadScheduler();
+    }
+    return s_instance;
+}
+
+void GAFTextureUploadScheduler::destroyInstance()
+{
+    delete s_instance;
+    s_instance = nullptr;
+}
+
+void GAFTextureUploadScheduler::scheduleUpload(GAFAssetTextureManager* manager, UploadedDelegate_t callback /*= nullptr*/)
+{
+    manager->retain();
+    manager->decodeImagesAsync();
+
+    Job job = { manager, callback };
+    m_jobs.push_back(job);
+
+    _setScheduled(true);
+}
+
+void GAFTextureUploadScheduler::cancelUpload(GAFAssetTextureManager* manager)
+{
+    for (Jobs_t::iterator i = m_jobs.begin(); i != m_jobs.end();)
+    {
+        if (i->manager == manager)
+        {
+            i->manager->release();
+            i = m_jobs.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    if (m_jobs.empty())
+    {
+        _setScheduled(false);
+    }
+}
+
+bool GAFTextureUploadScheduler::isUploading(const GAFAssetTextureManager* manager) const
+{
+    for (Jobs_t::const_iterator i = m_jobs.begin(), e = m_jobs.end(); i != e; ++i)
+    {
+        if (i->manager == manager)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GAFTextureUploadScheduler::_setScheduled(bool value)
+{
+    if (m_isScheduled == value)
+    {
+        return;
+    }
+
+    cocos2d::Scheduler* scheduler = cocos2d::Director::getInstance()->getScheduler();
+
+    if (value)
+    {
+        scheduler->schedule(std::bind(&GAFTextureUploadScheduler::_update, this, std::placeholders::_1), this, 0.f, false, s_scheduleKey);
+    }
+    else
+    {
+        scheduler->unschedule(s_scheduleKey, this);
+    }
+
+    m_isScheduled = value;
+}
+
+void GAFTextureUploadScheduler::_update(float dt)
+{
+    (void)dt;
+
+    typedef std::chrono::steady_clock Clock_t;
+    const Clock_t::time_point start = Clock_t::now();
+
+    std::vector<UploadedDelegate_t> finished;
+    size_t uploadsCount = 0;
+    bool isBudgetSpent = false;
+    bool hasProgress = true;
+
+    // Managers take turns, one texture each, while there is anything to upload and time for it
+    while (hasProgress && !isBudgetSpent && !m_jobs.empty())
+    {
+        hasProgress = false;
+
+        for (Jobs_t::iterator i = m_jobs.begin(); i != m_jobs.end();)
+        {
+            if (uploadsCount && std::chrono::duration<float, std::milli>(Clock_t::now() - start).count() >= m_frameBudget)
+            {
+                isBudgetSpent = true;
+                break;
+            }
+
+            // Images decoded after this check are picked up by the next call
+            const bool isDecoding = i->manager->isDecoding();
+
+            if (i->manager->uploadNextImage())
+            {
+                ++uploadsCount;
+                hasProgress = true;
+                ++i;
+            }
+            else if (!isDecoding)
+            {
+                finished.push_back(i->callback);
+                i->manager->release();
+                i = m_jobs.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    if (m_jobs.empty())
+    {
+        _setScheduled(false);
+    }
+
+    // Delegates may schedule more uploads
+    for (size_t i = 0; i < finished.size(); ++i)
+    {
+        if (finished[i])
+        {
+            finished[i]();
+        }
+    }
+}
+
+void GAFTextureUploadScheduler::setFrameBudget(float milliseconds)
+{
+    m_frameBudget = milliseconds;
+}
+
+float GAFTextureUploadScheduler::getFrameBudget() const
+{
+    return m_frameBudget;
+}
+
+NS_GAF_END
\ No newline at end of file
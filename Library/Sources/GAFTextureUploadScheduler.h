@@ -0,0 +1,60 @@
+#pragma once
+
+#include "GAFMacros.h"
+
+#include <functional>
+#include <list>
+
+NS_GAF_BEGIN
+
+class GAFAssetTextureManager;
+
+/// Creates textures of atlases on the main thread spending at most the frame budget on it every frame,
+/// so showing a big asset does not stall several frames. Images are decoded on a worker thread meanwhile.
+/// At least one texture is created every frame whatever the budget is
+/// @note must be used on the main thread only
+class GAFTextureUploadScheduler
+{
+public:
+    typedef std::function<void()> UploadedDelegate_t;
+
+private:
+    struct Job
+    {
+        GAFAssetTextureManager* manager;
+        UploadedDelegate_t      callback;
+    };
+
+    typedef std::list<Job> Jobs_t;
+
+    Jobs_t              m_jobs;
+    float               m_frameBudget;
+    bool                m_isScheduled;
+
+    static GAFTextureUploadScheduler* s_instance;
+
+    GAFTextureUploadScheduler();
+
+    void                _update(float dt);
+    void                _setScheduled(bool value);
+
+public:
+    ~GAFTextureUploadScheduler();
+
+    static GAFTextureUploadScheduler* getInstance();
+    /// Drops all scheduled uploads without calling their delegates
+    static void         destroyInstance();
+
+    /// Creates textures of all atlases of the manager over the next frames. The manager is retained till then
+    /// @param callback is called once every atlas has a texture
+    void                scheduleUpload(GAFAssetTextureManager* manager, UploadedDelegate_t callback = nullptr);
+    /// Stops uploading textures of the manager, the delegate is not called
+    void                cancelUpload(GAFAssetTextureManager* manager);
+    bool                isUploading(const GAFAssetTextureManager* manager) const;
+
+    /// Milliseconds to spend on creating textures every frame. Default is GAF_TEXTURE_UPLOAD_BUDGET
+    void                setFrameBudget(float milliseconds);
+    float               getFrameBudget() const;
+};
+
+NS_GAF_END
\ No newline at end of file
@@ -22,7 +22,7 @@ m_id(id)
 GAFTimeline::~GAFTimeline()
 {
     GAF_RELEASE_ARRAY(TextureAtlases_t, m_textureAtlases);
-    GAF_RELEASE_ARRAY(AnimationFrames_t, m_animationFrames);
+    m_animationFrames.clear(); // Frames are owned by the asset arena
     GAF_RELEASE_MAP(TextsData_t, m_textsData);
     GAF_RELEASE_MAP(CustomData_t, m_userData);
 }
@@ -45,6 +45,40 @@ void GAFTimeline::pushAnimationObject(uint32_t objectId, uint32_t elementAtlasId
 void GAFTimeline::pushAnimationFrame(GAFAnimationFrame* frame)
 {
     m_animationFrames.push_back(frame);
+
+    if (m_changedSlotsOffsets.empty())
+    {
+        m_changedSlotsOffsets.push_back(0);
+    }
+
+    // Delta frames may store states that are the same as before, interned records make them the same indices
+    const uint32_t* states = frame->getObjectStates();
+    const uint32_t* slots = frame->getStateSlots();
+    const uint32_t count = frame->getObjectStatesCount();
+
+    if (frame->isKeyframe())
+    {
+        m_pushedStates.resize(std::max<size_t>(m_pushedStates.size(), count), IDNONE);
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint32_t slot = slots ? slots[i] : i;
+
+        if (slot < m_pushedStates.size() && m_pushedStates[slot] != states[i])
+        {
+            m_pushedStates[slot] = states[i];
+            m_changedSlots.push_back(slot);
+        }
+    }
+
+    m_changedSlotsOffsets.push_back(static_cast<uint32_t>(m_changedSlots.size()));
+}
+
+void GAFTimeline::endLoading()
+{
+    m_states.endLoading();
+    GAFAnimationFrame::SubobjectStates_t().swap(m_pushedStates);
 }
 
 void GAFTimeline::pushAnimationSequence(const std::string& nameId, int start, int end)
@@ -102,6 +136,59 @@ const AnimationFrames_t& GAFTimeline::getAnimationFrames() const
     return m_animationFrames;
 }
 
+const GAFStateStore& GAFTimeline::getStates() const
+{
+    return m_states;
+}
+
+GAFStateStore& GAFTimeline::getStates()
+{
+    return m_states;
+}
+
+void GAFTimeline::getFrameStates(uint32_t frameIndex, GAFAnimationFrame::SubobjectStates_t& states, uint32_t& statesFrame) const
+{
+    if (statesFrame == frameIndex)
+        return;
+
+    uint32_t first = frameIndex;
+    while (first > 0 && !m_animationFrames[first]->isKeyframe())
+    {
+        --first;
+    }
+
+    if (statesFrame != IDNONE && statesFrame >= first && statesFrame < frameIndex)
+    {
+        first = statesFrame + 1;
+    }
+
+    for (uint32_t i = first; i <= frameIndex; ++i)
+    {
+        m_animationFrames[i]->applyObjectStates(states);
+    }
+
+    statesFrame = frameIndex;
+}
+
+void GAFTimeline::getChangedSlots(uint32_t frameIndex, const uint32_t*& slots, uint32_t& count) const
+{
+    if (frameIndex + 1 >= m_changedSlotsOffsets.size())
+    {
+        slots = nullptr;
+        count = 0;
+        return;
+    }
+
+    const uint32_t begin = m_changedSlotsOffsets[frameIndex];
+    slots = m_changedSlots.data() + begin;
+    count = m_changedSlotsOffsets[frameIndex + 1] - begin;
+}
+
+bool GAFTimeline::isStaticFrame(uint32_t frameIndex) const
+{
+    return frameIndex + 1 < m_changedSlotsOffsets.size() && m_changedSlotsOffsets[frameIndex] == m_changedSlotsOffsets[frameIndex + 1];
+}
+
 const AnimationSequences_t& GAFTimeline::getAnimationSequences() const
 {
     return m_animationSequences;
@@ -185,6 +272,11 @@ uint32_t GAFTimeline::getFramesCount() const
     return m_framesCount;
 }
 
+uint32_t GAFTimeline::getId() const
+{
+    return m_id;
+}
+
 const cocos2d::Rect GAFTimeline::getRect() const
 {
     return m_aabb;
@@ -236,6 +328,29 @@ void GAFTimeline::_chooseTextureAtlas(float desiredAtlasScale)
     m_usedAtlasContentScaleFactor = atlasScale;
 }
 
+GAFTextureAtlas* GAFTimeline::getTextureAtlasForScale(float scale) const
+{
+    GAFTextureAtlas* result = nullptr;
+    GAFTextureAtlas* biggest = nullptr;
+
+    for (TextureAtlases_t::const_iterator i = m_textureAtlases.begin(), e = m_textureAtlases.end(); i != e; ++i)
+    {
+        const float as = (*i)->getScale();
+
+        if (as >= scale && (!result || as < result->getScale()))
+        {
+            result = *i;
+        }
+
+        if (!biggest || as > biggest->getScale())
+        {
+            biggest = *i;
+        }
+    }
+
+    return result ? result : biggest;
+}
+
 float GAFTimeline::usedAtlasScale() const
 {
     return m_usedAtlasContentScaleFactor;
@@ -4,6 +4,7 @@
 #include "GAFHeader.h"
 
 #include "GAFDelegates.h"
+#include "GAFAnimationFrame.h"
 
 NS_GAF_BEGIN
 
@@ -16,6 +17,10 @@ private:
     AnimationMasks_t        m_animationMasks;
     AnimationObjects_t      m_animationObjects;
     AnimationFrames_t       m_animationFrames;
+    GAFStateStore           m_states;
+    std::vector<uint32_t>   m_changedSlots;         // Slots of every frame whose states differ from the previous frame, frame after frame
+    std::vector<uint32_t>   m_changedSlotsOffsets;  // Where the slots of every frame start in m_changedSlots, and the end
+    GAFAnimationFrame::SubobjectStates_t m_pushedStates; // States of the last pushed frame
     AnimationSequences_t    m_animationSequences;
     NamedParts_t            m_namedParts;
     TextsData_t             m_textsData;
@@ -50,6 +55,8 @@ public:
     void                        pushAnimationMask(uint32_t objectId, uint32_t elementAtlasIdRef, GAFCharacterType charType);
     void                        pushAnimationObject(uint32_t objectId, uint32_t elementAtlasIdRef, GAFCharacterType charType);
     void                        pushAnimationFrame(GAFAnimationFrame* frame);
+    /// Drops what only pushing frames needs once all of them are pushed
+    void                        endLoading();
     void                        pushAnimationSequence(const std::string& nameId, int start, int end);
     void                        pushNamedPart(uint32_t objectIdRef, const std::string& name);
     void                        pushTextData(uint32_t objectIdRef, GAFTextData* textField);
@@ -64,11 +71,24 @@ public:
     const AnimationObjects_t&   getAnimationObjects() const;
     const AnimationMasks_t&     getAnimationMasks() const;
     const AnimationFrames_t&	getAnimationFrames() const;
+    /// Object states all animation frames refer to
+    const GAFStateStore&        getStates() const;
+    GAFStateStore&              getStates();
+    /// Fills states of every animation object (ordered by object id) for the given frame
+    /// @param statesFrame frame that states currently hold or IDNONE, updated to frameIndex.
+    /// Successive frames are reached by applying changes, other ones are rebuilt from the nearest keyframe
+    void                        getFrameStates(uint32_t frameIndex, GAFAnimationFrame::SubobjectStates_t& states, uint32_t& statesFrame) const;
+    /// Slots (ascending) whose states differ between the frame and the previous one, found when frames are pushed.
+    /// They are the same slots going from the frame back to the previous one. All slots change in the first frame
+    void                        getChangedSlots(uint32_t frameIndex, const uint32_t*& slots, uint32_t& count) const;
+    /// No state differs from the previous frame
+    bool                        isStaticFrame(uint32_t frameIndex) const;
     const AnimationSequences_t& getAnimationSequences() const;
     const NamedParts_t&         getNamedParts() const;
     const TextsData_t&          getTextsData() const;
     const TextureAtlases_t&     getTextureAtlases() const;
     uint32_t                    getFramesCount() const;
+    uint32_t                    getId() const;
 
     const cocos2d::Rect         getRect() const;
     const cocos2d::Point        getPivot() const;
@@ -85,6 +105,8 @@ public:
     GAFTimeline*                getParent() const;
 
     GAFTextureAtlas*            getTextureAtlas();
+    /// Atlas with the smallest scale that is not below the given one, or the biggest atlas
+    GAFTextureAtlas*            getTextureAtlasForScale(float scale) const;
     void                        loadImages(float desiredAtlasScale);
 
     float                       usedAtlasScale() const;
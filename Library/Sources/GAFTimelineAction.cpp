@@ -35,7 +35,7 @@ void GAFTimelineAction::setAction(GAFActionType type, ActionParams_t params, con
     }
 }
 
-GAFActionType GAFTimelineAction::getType()
+GAFActionType GAFTimelineAction::getType() const
 {
     return m_type;
 }
@@ -48,4 +48,14 @@ const std::string GAFTimelineAction::getParam(ParameterIndex idx)
     return m_params[idx];
 }
 
+const ActionParams_t& GAFTimelineAction::getParams() const
+{
+    return m_params;
+}
+
+const std::string& GAFTimelineAction::getScope() const
+{
+    return m_scope;
+}
+
 NS_GAF_END
\ No newline at end of file
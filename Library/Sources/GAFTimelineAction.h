@@ -21,8 +21,10 @@ public:
 	};
 
     void setAction(GAFActionType type, ActionParams_t params, const std::string& scope);
-    GAFActionType getType();
+    GAFActionType getType() const;
 	const std::string getParam(ParameterIndex idx);
+    const ActionParams_t& getParams() const;
+    const std::string& getScope() const;
 
 private:
     GAFActionType m_type;
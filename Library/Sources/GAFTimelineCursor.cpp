@@ -0,0 +1,94 @@
+#include "GAFPrecompiled.h"
+#include "GAFTimelineCursor.h"
+#include "GAFAsset.h"
+#include "GAFTimeline.h"
+#include "GAFSoundInfo.h"
+
+NS_GAF_BEGIN
+
+GAFTimelineCursor::GAFTimelineCursor()
+: currentFrame(GAFFirstFrameIndex)
+, showingFrame(GAFFirstFrameIndex)
+, sequenceStart(GAFFirstFrameIndex)
+, sequenceEnd(GAFFirstFrameIndex)
+, isRunning(false)
+, isLooped(false)
+, isReversed(false)
+, isInResetState(false)
+{
+}
+
+bool GAFTimelineCursor::isLastFrameInSequence() const
+{
+    if (isReversed)
+        return currentFrame == sequenceStart;
+    return currentFrame == sequenceEnd - 1;
+}
+
+uint32_t GAFTimelineCursor::nextFrame() const
+{
+    if (isLastFrameInSequence())
+    {
+        if (!isLooped)
+            return currentFrame;
+
+        if (isReversed)
+            return sequenceEnd - 1;
+        else
+            return sequenceStart;
+    }
+
+    return currentFrame + (isReversed ? -1 : 1);
+}
+
+void GAFTimelineCursor::advance()
+{
+    showingFrame = currentFrame;
+    currentFrame = nextFrame();
+}
+
+bool GAFTimelineCursor::updateResetState(float alpha)
+{
+    if (alpha >= 0.f && isInResetState)
+    {
+        currentFrame = sequenceStart;
+    }
+    isInResetState = alpha < 0.f;
+
+    return isInResetState;
+}
+
+uint32_t GAFTimelineCursor::findFrame(const GAFTimeline* timeline, const std::string& frameLabel)
+{
+    uint32_t frame = IDNONE;
+    const GAFAnimationSequence* seq = timeline->getSequence(frameLabel);
+    if (seq)
+    {
+        frame = seq->startFrameNo;
+    }
+    else
+    {
+        const uint32_t frameNumber = atoi(frameLabel.c_str());
+        if (frameNumber != 0)
+        {
+            frame = frameNumber - 1;
+        }
+    }
+
+    return frame < timeline->getFramesCount() ? frame : IDNONE;
+}
+
+void GAFTimelineCursor::dispatchEvent(GAFTimelineAction& action, GAFAsset* asset, cocos2d::EventDispatcher* dispatcher)
+{
+    std::string type = action.getParam(GAFTimelineAction::PI_EVENT_TYPE);
+    if (type.compare(GAFSoundInfo::SoundEvent) == 0)
+    {
+        asset->soundEvent(&action);
+    }
+    else
+    {
+        dispatcher->dispatchCustomEvent(type, &action);
+    }
+}
+
+NS_GAF_END
\ No newline at end of file
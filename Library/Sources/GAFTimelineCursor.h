@@ -0,0 +1,96 @@
+#pragma once
+
+#include "GAFAnimationFrame.h"
+
+NS_GAF_BEGIN
+
+class GAFAsset;
+class GAFTimeline;
+
+/// Playback position of a timeline: the frame it is on, the sequence it plays and the way it plays it.
+/// GAFObject and GAFTimelineEvaluator advance timelines and perform their actions with it
+struct GAFTimelineCursor
+{
+    uint32_t    currentFrame;
+    uint32_t    showingFrame;   // Frame number that is valid from the beginning of realize frame
+    uint32_t    sequenceStart;
+    uint32_t    sequenceEnd;
+    bool        isRunning;
+    bool        isLooped;
+    bool        isReversed;
+    bool        isInResetState; // Enclosed timeline hidden by a state with negative alpha
+
+    GAFTimelineCursor();
+
+    bool        isLastFrameInSequence() const;
+    /// Frame that follows the current one in the sequence, the current one when it is the last and not looped
+    uint32_t    nextFrame() const;
+    /// Shows the current frame and moves to the next one
+    void        advance();
+
+    /// Applies alpha of the state the enclosed timeline is placed with, a negative one resets the timeline
+    /// to the start of its sequence once it is placed with a non-negative one again
+    /// @returns true if the timeline is in the reset state and is not shown
+    bool        updateResetState(float alpha);
+
+    /// Performs the actions of a frame of the timeline. Goto actions move the cursor to their frame,
+    /// call realize() for it and then run or stop the same as the rest of the actions do.
+    /// Events are passed to dispatch(GAFTimelineAction&)
+    template <typename Realize, typename Dispatch>
+    void        performActions(const GAFAnimationFrame* frame, const GAFTimeline* timeline, Realize realize, Dispatch dispatch);
+    /// The same dispatching events right away, see dispatchEvent
+    template <typename Realize>
+    void        performActions(const GAFAnimationFrame* frame, const GAFTimeline* timeline, GAFAsset* asset, cocos2d::EventDispatcher* dispatcher, Realize realize);
+
+    /// Start of the sequence or the frame number goto actions refer to, IDNONE if there is no such frame
+    static uint32_t findFrame(const GAFTimeline* timeline, const std::string& frameLabel);
+
+    /// Sound events go to the asset, the rest are dispatched as custom events
+    static void dispatchEvent(GAFTimelineAction& action, GAFAsset* asset, cocos2d::EventDispatcher* dispatcher);
+};
+
+template <typename Realize, typename Dispatch>
+void GAFTimelineCursor::performActions(const GAFAnimationFrame* frame, const GAFTimeline* timeline, Realize realize, Dispatch dispatch)
+{
+    // Actions are copied, a goto realizes another frame of the same timeline
+    GAFAnimationFrame::TimelineActions_t timelineActions = frame->getTimelineActions();
+    for (GAFTimelineAction& action : timelineActions)
+    {
+        switch (action.getType())
+        {
+        case GAFActionType::Stop:
+            isRunning = false;
+            break;
+        case GAFActionType::Play:
+            isRunning = true;
+            break;
+        case GAFActionType::GotoAndStop:
+        case GAFActionType::GotoAndPlay:
+            {
+                const uint32_t frameIndex = findFrame(timeline, action.getParam(GAFTimelineAction::PI_FRAME));
+                if (frameIndex != IDNONE)
+                {
+                    showingFrame = currentFrame = frameIndex;
+                    realize();
+                    isRunning = action.getType() == GAFActionType::GotoAndPlay;
+                }
+            }
+            break;
+        case GAFActionType::DispatchEvent:
+            dispatch(action);
+            break;
+
+        case GAFActionType::None:
+        default:
+            break;
+        }
+    }
+}
+
+template <typename Realize>
+void GAFTimelineCursor::performActions(const GAFAnimationFrame* frame, const GAFTimeline* timeline, GAFAsset* asset, cocos2d::EventDispatcher* dispatcher, Realize realize)
+{
+    performActions(frame, timeline, realize, [asset, dispatcher](GAFTimelineAction& action) { dispatchEvent(action, asset, dispatcher); });
+}
+
+NS_GAF_END
\ No newline at end of file
@@ -0,0 +1,422 @@
+#include "GAFPrecompiled.h"
+#include "GAFTimelineEvaluator.h"
+#include "GAFAsset.h"
+#include "GAFTimeline.h"
+#include "GAFTextureAtlas.h"
+#include "GAFTextureAtlasElement.h"
+#include "GAFSubobjectState.h"
+
+NS_GAF_BEGIN
+
+static const float s_identityColorMults[4] = { 1.f, 1.f, 1.f, 1.f };
+static const float s_identityColorOffsets[4] = { 0.f, 0.f, 0.f, 0.f };
+
+// The same as GAFObject does for objects of a timeline that is not flipped
+static cocos2d::AffineTransform cocosFormatFromFlashFormat(const cocos2d::AffineTransform& aTransform)
+{
+    cocos2d::AffineTransform transform = aTransform;
+    transform.b = -transform.b;
+    transform.c = -transform.c;
+    transform.ty = -transform.ty;
+    return transform;
+}
+
+GAFTimelineEvaluator::GAFTimelineEvaluator(GAFAsset* asset, GAFTimeline* timeline)
+: m_asset(asset)
+, m_isTimelinesIncluded(false)
+, m_isEventsDeferred(false)
+{
+    CCAssert(asset, "Asset should not be nil");
+    CCAssert(timeline, "Timeline should not be nil");
+
+    CC_SAFE_RETAIN(m_asset);
+    _addInstance(timeline);
+
+    // Instances have been moved while they were added
+    for (Instances_t::iterator i = m_instances.begin(), e = m_instances.end(); i != e; ++i)
+    {
+        i->cursor = &i->ownCursor;
+    }
+}
+
+GAFTimelineEvaluator::~GAFTimelineEvaluator()
+{
+    CC_SAFE_RELEASE(m_asset);
+}
+
+uint32_t GAFTimelineEvaluator::_addInstance(GAFTimeline* timeline)
+{
+    const uint32_t index = static_cast<uint32_t>(m_instances.size());
+
+    Instance instance;
+    instance.timeline = timeline;
+    instance.frameStatesIndex = IDNONE;
+    instance.ownCursor.sequenceEnd = timeline->getFramesCount();
+    m_instances.push_back(instance);
+
+    // Only nested timelines become instances, the rest are leaves
+    std::vector<uint32_t> children;
+    Timelines_t& timelines = m_asset->getTimelines();
+    const AnimationObjects_t& objects = timeline->getAnimationObjects();
+
+    for (AnimationObjects_t::const_iterator i = objects.begin(), e = objects.end(); i != e; ++i)
+    {
+        if (std::get<1>(i->second) != GAFCharacterType::Timeline)
+        {
+            continue;
+        }
+
+        Timelines_t::iterator tl = timelines.find(std::get<0>(i->second));
+        CCAssert(tl != timelines.end(), "Invalid object reference.");
+        if (tl == timelines.end())
+        {
+            continue;
+        }
+
+        if (children.size() <= i->first)
+        {
+            children.resize(i->first + 1, IDNONE);
+        }
+        children[i->first] = _addInstance(tl->second);
+    }
+
+    m_instances[index].children.swap(children);
+    return index;
+}
+
+void GAFTimelineEvaluator::start()
+{
+    Instance& root = m_instances.front();
+    if (!root.cursor->isRunning)
+    {
+        root.cursor->currentFrame = root.cursor->isReversed ? root.timeline->getFramesCount() - 1 : GAFFirstFrameIndex;
+
+        for (Instances_t::iterator i = m_instances.begin(), e = m_instances.end(); i != e; ++i)
+        {
+            i->cursor->isRunning = true;
+        }
+    }
+}
+
+void GAFTimelineEvaluator::stop()
+{
+    Instance& root = m_instances.front();
+    if (root.cursor->isRunning)
+    {
+        root.cursor->currentFrame = GAFFirstFrameIndex;
+
+        for (Instances_t::iterator i = m_instances.begin(), e = m_instances.end(); i != e; ++i)
+        {
+            i->cursor->isRunning = false;
+        }
+    }
+}
+
+bool GAFTimelineEvaluator::isRunning() const
+{
+    return m_instances.front().cursor->isRunning;
+}
+
+void GAFTimelineEvaluator::setLooped(bool looped, bool recursive /*= false*/)
+{
+    if (!recursive)
+    {
+        m_instances.front().cursor->isLooped = looped;
+        return;
+    }
+
+    for (Instances_t::iterator i = m_instances.begin(), e = m_instances.end(); i != e; ++i)
+    {
+        i->cursor->isLooped = looped;
+    }
+}
+
+bool GAFTimelineEvaluator::isLooped() const
+{
+    return m_instances.front().cursor->isLooped;
+}
+
+bool GAFTimelineEvaluator::playSequence(const std::string& name, bool looped)
+{
+    Instance& root = m_instances.front();
+
+    const GAFAnimationSequence* seq = name.empty() ? nullptr : root.timeline->getSequence(name);
+    if (!seq)
+    {
+        return false;
+    }
+
+    root.cursor->sequenceStart = seq->startFrameNo;
+    root.cursor->sequenceEnd = seq->endFrameNo;
+    root.cursor->currentFrame = root.cursor->isReversed ? seq->endFrameNo - 1 : seq->startFrameNo;
+    root.cursor->isLooped = looped;
+    root.cursor->isRunning = true;
+
+    return true;
+}
+
+uint32_t GAFTimelineEvaluator::getCurrentFrameIndex() const
+{
+    return m_instances.front().cursor->showingFrame;
+}
+
+uint32_t GAFTimelineEvaluator::getTotalFrameCount() const
+{
+    return m_instances.front().timeline->getFramesCount();
+}
+
+size_t GAFTimelineEvaluator::getInstancesCount() const
+{
+    return m_instances.size();
+}
+
+uint32_t GAFTimelineEvaluator::getChildInstance(uint32_t instance, uint32_t objectId) const
+{
+    const std::vector<uint32_t>& children = m_instances[instance].children;
+    return objectId < children.size() ? children[objectId] : IDNONE;
+}
+
+const GAFAnimationFrame::SubobjectStates_t& GAFTimelineEvaluator::getFrameStates(uint32_t instance, uint32_t& frameIndex) const
+{
+    frameIndex = m_instances[instance].frameStatesIndex;
+    return m_instances[instance].frameStates;
+}
+
+void GAFTimelineEvaluator::setCursor(uint32_t instance, GAFTimelineCursor* cursor)
+{
+    m_instances[instance].cursor = cursor ? cursor : &m_instances[instance].ownCursor;
+}
+
+void GAFTimelineEvaluator::setTimelinesIncluded(bool value)
+{
+    m_isTimelinesIncluded = value;
+}
+
+void GAFTimelineEvaluator::setEventsDeferred(bool value)
+{
+    m_isEventsDeferred = value;
+}
+
+void GAFTimelineEvaluator::dispatchDeferredEvents(cocos2d::EventDispatcher* dispatcher)
+{
+    // Listeners may step the evaluator again
+    GAFAnimationFrame::TimelineActions_t events;
+    events.swap(m_deferredEvents);
+
+    for (GAFAnimationFrame::TimelineActions_t::iterator i = events.begin(), e = events.end(); i != e; ++i)
+    {
+        GAFTimelineCursor::dispatchEvent(*i, m_asset, dispatcher);
+    }
+}
+
+void GAFTimelineEvaluator::_dispatchEvent(GAFTimelineAction& action)
+{
+    if (m_isEventsDeferred)
+    {
+        m_deferredEvents.push_back(action);
+    }
+    else
+    {
+        GAFTimelineCursor::dispatchEvent(action, m_asset, cocos2d::Director::getInstance()->getEventDispatcher());
+    }
+}
+
+void GAFTimelineEvaluator::step(const cocos2d::AffineTransform& transform, Objects_t& out)
+{
+    out.clear();
+    _step(0, transform, s_identityColorMults, s_identityColorOffsets, out);
+}
+
+void GAFTimelineEvaluator::_step(uint32_t index, const cocos2d::AffineTransform& transform, const float* colorMults, const float* colorOffsets, Objects_t& out)
+{
+    GAFTimelineCursor& cursor = *m_instances[index].cursor;
+    cursor.showingFrame = cursor.currentFrame;
+
+    if (!cursor.isRunning)
+    {
+        _realizeFrame(index, transform, colorMults, colorOffsets, out);
+        return;
+    }
+
+    if (cursor.isLastFrameInSequence() && !cursor.isLooped)
+    {
+        cursor.isRunning = false;
+    }
+
+    _realizeFrame(index, transform, colorMults, colorOffsets, out);
+
+    cursor.advance();
+}
+
+void GAFTimelineEvaluator::_sortForDrawing(uint32_t index, size_t outStart, Objects_t& out)
+{
+    std::vector<Range>& drawOrder = m_instances[index].drawOrder;
+
+    // Children of a node are drawn by z order and then in the order they were added
+    std::stable_sort(drawOrder.begin(), drawOrder.end(), [](const Range& a, const Range& b)
+    {
+        return a.zIndex < b.zIndex;
+    });
+
+    bool isSorted = true;
+    for (size_t i = 1; i < drawOrder.size() && isSorted; ++i)
+    {
+        isSorted = drawOrder[i - 1].begin <= drawOrder[i].begin;
+    }
+
+    if (isSorted)
+    {
+        return;
+    }
+
+    m_sorted.clear();
+    for (std::vector<Range>::const_iterator i = drawOrder.begin(), e = drawOrder.end(); i != e; ++i)
+    {
+        m_sorted.insert(m_sorted.end(), out.begin() + i->begin, out.begin() + i->end);
+    }
+
+    std::copy(m_sorted.begin(), m_sorted.end(), out.begin() + outStart);
+}
+
+void GAFTimelineEvaluator::_realizeFrame(uint32_t index, const cocos2d::AffineTransform& transform, const float* colorMults, const float* colorOffsets, Objects_t& out)
+{
+    Instance& instance = m_instances[index];
+    GAFTimeline* timeline = instance.timeline;
+    const uint32_t frameIndex = instance.cursor->currentFrame;
+
+    const AnimationFrames_t& animationFrames = timeline->getAnimationFrames();
+    if (animationFrames.size() <= frameIndex)
+    {
+        return;
+    }
+
+    const size_t outStart = out.size();
+
+    timeline->getFrameStates(frameIndex, instance.frameStates, instance.frameStatesIndex);
+
+    const GAFStateStore& store = timeline->getStates();
+    const uint32_t* objectIds = store.getObjectIds();
+    const int* zIndices = store.getZIndices();
+
+    const AnimationMasks_t& masks = timeline->getAnimationMasks();
+    const AnimationObjects_t& objects = timeline->getAnimationObjects();
+    const GAFTextureAtlas* atlas = timeline->getTextureAtlas();
+
+    // States are evaluated in the order of the frame, nested timelines are stepped in it
+    instance.drawOrder.clear();
+
+    for (uint32_t slot = 0, slotsCount = static_cast<uint32_t>(instance.frameStates.size()); slot < slotsCount; ++slot)
+    {
+        const uint32_t state = instance.frameStates[slot];
+        const uint32_t objectId = objectIds[state];
+        const float alpha = store.getColorMults()[state * 4 + GAFColorTransformIndex::GAFCTI_A];
+
+        const uint32_t child = objectId < instance.children.size() ? instance.children[objectId] : IDNONE;
+        if (child != IDNONE)
+        {
+            if (m_instances[child].cursor->updateResetState(alpha))
+                continue;
+        }
+
+        if (!store.isVisible(state))
+        {
+            continue;
+        }
+
+        const Range range = { zIndices[state], out.size(), out.size() };
+        instance.drawOrder.push_back(range);
+
+        const float* stateColorMults = store.getColorMults() + state * 4;
+        const float* stateColorOffsets = store.getColorOffsets() + state * 4;
+
+        float mults[4];
+        float offsets[4];
+        for (int c = 0; c < 4; ++c)
+        {
+            mults[c] = colorMults[c] * stateColorMults[c];
+            offsets[c] = colorOffsets[c] + stateColorOffsets[c];
+        }
+
+        const cocos2d::AffineTransform t = cocos2d::AffineTransformConcat(cocosFormatFromFlashFormat(store.getTransforms()[state]), transform);
+
+        AnimationMasks_t::const_iterator maskIt = masks.find(objectId);
+        const bool isMask = maskIt != masks.end();
+        AnimationObjects_t::const_iterator objectIt = objects.find(objectId);
+        if (!isMask && objectIt == objects.end())
+        {
+            continue;
+        }
+
+        const AnimationObjectEx_t& objectEx = isMask ? maskIt->second : objectIt->second;
+
+        GAFEvaluatedObject object;
+        object.timeline = timeline;
+        object.instance = index;
+        object.objectId = objectId;
+        object.maskObjectId = store.getMaskObjectIds()[state];
+        object.type = std::get<1>(objectEx);
+        object.reference = std::get<0>(objectEx);
+        object.isMask = isMask;
+        object.element = nullptr;
+        object.transform = t;
+        std::copy(mults, mults + 4, object.colorMults);
+        std::copy(offsets, offsets + 4, object.colorOffsets);
+        object.zIndex = zIndices[state];
+        object.state = state;
+        object.slot = slot;
+
+        if (child != IDNONE)
+        {
+            if (m_isTimelinesIncluded)
+            {
+                out.push_back(object);
+            }
+
+            _step(child, t, mults, offsets, out);
+            instance.drawOrder.back().end = out.size();
+            continue;
+        }
+
+        if (object.type == GAFCharacterType::Texture)
+        {
+            // Textures are placed by their elements, there are none till atlases are chosen on loading images
+            if (!atlas)
+            {
+                continue;
+            }
+
+            const GAFTextureAtlas::Elements_t& elements = atlas->getElements();
+            GAFTextureAtlas::Elements_t::const_iterator elIt = elements.find(object.reference);
+            if (elIt == elements.end())
+            {
+                continue;
+            }
+
+            // Placed the same as the sprite of the element, see GAFSprite::getNodeToParentTransform
+            const GAFTextureAtlasElement* element = elIt->second;
+            const float height = element->rotation != GAFRotation::NONE ? element->bounds.size.width : element->bounds.size.height;
+            const float atlasScale = 1.f / element->getScale();
+
+            cocos2d::AffineTransform local = cocos2d::AffineTransformScale(cocosFormatFromFlashFormat(store.getTransforms()[state]), atlasScale, atlasScale);
+            local = cocos2d::AffineTransformTranslate(local, -element->pivotPoint.x, -(height - element->pivotPoint.y));
+
+            object.element = element;
+            object.transform = cocos2d::AffineTransformConcat(local, transform);
+        }
+
+        out.push_back(object);
+        instance.drawOrder.back().end = out.size();
+    }
+
+    _sortForDrawing(index, outStart, out);
+
+    // Objects of the frame are replaced with the ones of the frame a goto action moves to
+    instance.cursor->performActions(animationFrames[frameIndex], timeline, [&]()
+    {
+        out.resize(outStart);
+        _realizeFrame(index, transform, colorMults, colorOffsets, out);
+    },
+    [this](GAFTimelineAction& action) { _dispatchEvent(action); });
+}
+
+NS_GAF_END
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "GAFCollections.h"
+#include "GAFAnimationFrame.h"
+#include "GAFTimelineCursor.h"
+
+NS_GAF_BEGIN
+
+class GAFAsset;
+class GAFTimeline;
+class GAFTextureAtlasElement;
+
+/// Visible texture, mask or text field of an evaluated frame, or nested timeline when they are included
+struct GAFEvaluatedObject
+{
+    const GAFTimeline*              timeline;       // Timeline the object is placed in
+    uint32_t                        instance;       // Instance of the timeline, objects of one nested timeline share it
+    uint32_t                        objectId;
+    uint32_t                        maskObjectId;   // Mask of the object in the same instance or IDNONE
+    GAFCharacterType                type;
+    uint32_t                        reference;      // Atlas element, text data or timeline id
+    bool                            isMask;
+    const GAFTextureAtlasElement*   element;        // nullptr for text fields and timelines
+    cocos2d::AffineTransform        transform;      // Node to world, the one GAFSprite of the object would have
+    float                           colorMults[4];
+    float                           colorOffsets[4];
+    int                             zIndex;         // In its timeline
+    uint32_t                        state;          // In the state store of the timeline
+    uint32_t                        slot;           // Of the state in the frame states of the instance
+};
+
+/// Plays a timeline with all its nested timelines without making any nodes, the way GAFObject does.
+/// Every step evaluates the current frame into a flat list of visible objects in drawing order, so
+/// many instances of an animation are played without the scene graph. Rendering them is up to the user.
+/// Nested timelines are stepped in the order of their object ids as GAFObject does, only the output is sorted.
+/// Sequence delegates, filters and flipping are GAFObject features and are not supported here.
+/// Steps touch nothing but the evaluator and the cursors bound to it, so evaluators run on any thread
+/// when their events are deferred
+class GAFTimelineEvaluator
+{
+public:
+    typedef std::vector<GAFEvaluatedObject> Objects_t;
+
+private:
+    // Output of a visible state, a nested timeline outputs all its objects
+    struct Range
+    {
+        int             zIndex;
+        size_t          begin;
+        size_t          end;
+    };
+
+    struct Instance
+    {
+        GAFTimeline*                            timeline;
+        std::vector<uint32_t>                   children;   // Instance of every nested timeline by object id
+        GAFAnimationFrame::SubobjectStates_t    frameStates;
+        uint32_t                                frameStatesIndex;
+        std::vector<Range>                      drawOrder;  // Visible states of the frame, sorted by z index once evaluated
+        GAFTimelineCursor*                      cursor;     // ownCursor or a bound one
+        GAFTimelineCursor                       ownCursor;
+    };
+
+    typedef std::vector<Instance> Instances_t;
+
+    GAFAsset*           m_asset;
+    Instances_t         m_instances; // Root first, nested ones in depth first order
+    Objects_t           m_sorted;    // Output of an instance while it is sorted for drawing
+    bool                m_isTimelinesIncluded;
+    bool                m_isEventsDeferred;
+    GAFAnimationFrame::TimelineActions_t m_deferredEvents;
+
+    uint32_t            _addInstance(GAFTimeline* timeline);
+    void                _step(uint32_t index, const cocos2d::AffineTransform& transform, const float* colorMults, const float* colorOffsets, Objects_t& out);
+    void                _realizeFrame(uint32_t index, const cocos2d::AffineTransform& transform, const float* colorMults, const float* colorOffsets, Objects_t& out);
+    /// Orders the output of the instance that starts at outStart by z indices of the states
+    void                _sortForDrawing(uint32_t index, size_t outStart, Objects_t& out);
+    void                _dispatchEvent(GAFTimelineAction& action);
+
+    GAFTimelineEvaluator(const GAFTimelineEvaluator&) = delete;
+    GAFTimelineEvaluator& operator=(const GAFTimelineEvaluator&) = delete;
+
+public:
+    /// The asset is retained
+    GAFTimelineEvaluator(GAFAsset* asset, GAFTimeline* timeline);
+    ~GAFTimelineEvaluator();
+
+    /// Starts playing from the first frame including enclosed timelines, like GAFObject::start
+    void                start();
+    void                stop();
+    bool                isRunning() const;
+
+    void                setLooped(bool looped, bool recursive = false);
+    bool                isLooped() const;
+
+    /// Plays the sequence in the root timeline
+    bool                playSequence(const std::string& name, bool looped);
+
+    uint32_t            getCurrentFrameIndex() const;
+    uint32_t            getTotalFrameCount() const;
+    /// Timelines played, nested ones included
+    size_t              getInstancesCount() const;
+    /// Instance of the nested timeline placed as the object in the instance, IDNONE for other objects
+    uint32_t            getChildInstance(uint32_t instance, uint32_t objectId) const;
+    /// States of the frame the instance evaluated last, frameIndex is set to that frame or IDNONE
+    const GAFAnimationFrame::SubobjectStates_t& getFrameStates(uint32_t instance, uint32_t& frameIndex) const;
+
+    /// Plays the instance with a cursor kept elsewhere, GAFObject binds the cursors of its nodes.
+    /// nullptr goes back to the own cursor of the instance
+    void                setCursor(uint32_t instance, GAFTimelineCursor* cursor);
+
+    /// Nested timelines that are stepped are output too, each one before its objects. Off by default
+    void                setTimelinesIncluded(bool value);
+
+    /// Events are kept till dispatchDeferredEvents instead of being dispatched by the steps. Off by default
+    void                setEventsDeferred(bool value);
+    /// Dispatches the kept events in the order they were performed, sound events go to the asset
+    void                dispatchDeferredEvents(cocos2d::EventDispatcher* dispatcher);
+
+    /// Evaluates the current frame and advances every running timeline to its next frame.
+    /// Timeline actions are performed and events are dispatched the same as GAFObject does
+    /// @param transform node to world transform of the root timeline
+    /// @param out is cleared and filled with the visible objects in drawing order
+    void                step(const cocos2d::AffineTransform& transform, Objects_t& out);
+};
+
+NS_GAF_END
\ No newline at end of file
@@ -7,8 +7,11 @@ NS_GAF_BEGIN
 
 void PrimitiveDeserializer::deserialize(GAFStream* in, cocos2d::Vect* out)
 {
-    out->x = in->readFloat();
-    out->y = in->readFloat();
+    float v[2];
+    in->readFloats(v, 2);
+
+    out->x = v[0];
+    out->y = v[1];
 }
 
 void PrimitiveDeserializer::deserialize(GAFStream* in, cocos2d::Rect* out)
@@ -24,8 +27,11 @@ void PrimitiveDeserializer::deserialize(GAFStream* in, cocos2d::AffineTransform*
 
 void PrimitiveDeserializer::deserialize(GAFStream* in, cocos2d::Size* out)
 {
-    out->width = in->readFloat();
-    out->height = in->readFloat();
+    float v[2];
+    in->readFloats(v, 2);
+
+    out->width = v[0];
+    out->height = v[1];
 }
 
 void PrimitiveDeserializer::deserialize(GAFStream* in, cocos2d::Color4B* out)
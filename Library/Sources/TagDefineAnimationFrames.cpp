@@ -11,17 +11,10 @@
 #include "GAFSubobjectState.h"
 #include "GAFAnimationFrame.h"
 #include "GAFFilterData.h"
+#include "GAFArena.h"
 
 NS_GAF_BEGIN
 
-TagDefineAnimationFrames::~TagDefineAnimationFrames()
-{
-    for (States_t::iterator it = m_currentStates.begin(), ie = m_currentStates.end(); it != ie; ++it)
-    {
-        it->second->release();
-    }
-}
-
 void TagDefineAnimationFrames::read(GAFStream* in, GAFAsset* asset, GAFTimeline* timeline)
 {
     (void)asset;
@@ -29,14 +22,7 @@ void TagDefineAnimationFrames::read(GAFStream* in, GAFAsset* asset, GAFTimeline*
 
     if (timeline->getAnimationObjects().empty()) return;
 
-    for (AnimationObjects_t::const_iterator i = timeline->getAnimationObjects().begin(), e = timeline->getAnimationObjects().end(); i != e; ++i)
-    {
-        unsigned int objectId = i->first;
-        GAFSubobjectState *state = new GAFSubobjectState();
-        state->initEmpty(objectId);
-
-        m_currentStates[objectId] = state;
-    }
+    resetStates(timeline);
 
     const unsigned short totalFrameCount = in->getInput()->getHeader().framesCount;
 
@@ -48,67 +34,44 @@ void TagDefineAnimationFrames::read(GAFStream* in, GAFAsset* asset, GAFTimeline*
         {
             unsigned int numObjects = in->readU32();
 
-            typedef std::list<GAFSubobjectState*> StatesList_t;
-            StatesList_t statesList;
-
             for (unsigned int j = 0; j < numObjects; ++j)
             {
-                GAFSubobjectState* state = extractState(in);
-
-                statesList.push_back(state);
-            }
-
-            for (StatesList_t::iterator it = statesList.begin(), ie = statesList.end(); it != ie; ++it)
-            {
-                GAFSubobjectState* st = *it;
-
-                GAFSubobjectState* ps = m_currentStates[st->objectIdRef];
-
-                if (ps)
-                {
-                    ps->release();
-                }
-
-                m_currentStates[st->objectIdRef] = st;
+                readState(in, timeline);
             }
 
             if (in->getPosition() < in->getTagExpectedPosition())
                 frameNumber = in->readU32();
         }
 
-        GAFAnimationFrame* frame = new GAFAnimationFrame();
-
-        for (States_t::iterator it = m_currentStates.begin(), ie = m_currentStates.end(); it != ie; ++it)
-        {
-            frame->pushObjectState(it->second);
-        }
+        GAFAnimationFrame* frame = makeFrame(in, timeline);
 
         timeline->pushAnimationFrame(frame);
     }
+
+    timeline->endLoading();
+    clearStates();
 }
 
-GAFSubobjectState* TagDefineAnimationFrames::extractState(GAFStream* in)
+void TagDefineAnimationFrames::extractState(GAFStream* in, GAFSubobjectState& state)
 {
-    GAFSubobjectState* state = new GAFSubobjectState();
-
     float ctx[7];
 
     char hasColorTransform = in->readUByte();
     char hasMasks = in->readUByte();
     char hasEffect = in->readUByte();
 
-    state->objectIdRef = in->readU32();
-    state->zIndex = in->readS32();
-    state->colorMults()[GAFCTI_A] = in->readFloat();
+    state.objectIdRef = in->readU32();
+    state.zIndex = in->readS32();
+    state.colorMults()[GAFCTI_A] = in->readFloat();
 
-    PrimitiveDeserializer::deserialize(in, &state->affineTransform);
+    PrimitiveDeserializer::deserialize(in, &state.affineTransform);
 
     if (hasColorTransform)
     {
         in->readNBytesOfT(ctx, sizeof(float)* 7);
 
-        float* ctxOff = state->colorOffsets();
-        float* ctxMul = state->colorMults();
+        float* ctxOff = state.colorOffsets();
+        float* ctxMul = state.colorMults();
 
         ctxOff[GAFCTI_A] = ctx[0];
 
@@ -123,82 +86,18 @@ GAFSubobjectState* TagDefineAnimationFrames::extractState(GAFStream* in)
     }
     else
     {
-        state->ctxMakeIdentity();
+        state.ctxMakeIdentity();
     }
 
     if (hasEffect)
     {
-        unsigned char effects = in->readUByte();
-
-        for (unsigned int e = 0; e < effects; ++e)
-        {
-            GAFFilterType type = static_cast<GAFFilterType>(in->readU32());
-
-            if (type == GAFFilterType::Blur)
-            {
-                cocos2d::Size p;
-                PrimitiveDeserializer::deserialize(in, &p);
-                GAFBlurFilterData* blurFilter = new GAFBlurFilterData();
-                blurFilter->blurSize = p;
-                state->pushFilter(blurFilter);
-            }
-            else if (type == GAFFilterType::ColorMatrix)
-            {
-                GAFColorColorMatrixFilterData* colorFilter = new GAFColorColorMatrixFilterData();
-                for (unsigned int i = 0; i < 4; ++i)
-                {
-                    for (unsigned int j = 0; j < 4; ++j)
-                    {
-                        colorFilter->matrix[j * 4 + i] = in->readFloat();
-                    }
-
-                    colorFilter->matrix2[i] = in->readFloat() / 255.f;
-                }
-
-                state->pushFilter(colorFilter);
-            }
-            else if (type == GAFFilterType::Glow)
-            {
-                GAFGlowFilterData* filter = new GAFGlowFilterData();
-                unsigned int clr = in->readU32();
-
-                PrimitiveDeserializer::translateColor(filter->color, clr);
-                filter->color.a = 1.f;
-
-                PrimitiveDeserializer::deserialize(in, &filter->blurSize);
-
-                filter->strength = in->readFloat();
-                filter->innerGlow = in->readUByte() ? true : false;
-                filter->knockout = in->readUByte() ? true : false;
-
-                state->pushFilter(filter);
-            }
-            else if (type == GAFFilterType::DropShadow)
-            {
-                GAFDropShadowFilterData* filter = new GAFDropShadowFilterData();
-                unsigned int clr = in->readU32();
-
-                PrimitiveDeserializer::translateColor(filter->color, clr);
-                filter->color.a = 1.f;
-
-                PrimitiveDeserializer::deserialize(in, &filter->blurSize);
-                filter->angle = in->readFloat();
-                filter->distance = in->readFloat();
-                filter->strength = in->readFloat();
-                filter->innerShadow = in->readUByte() ? true : false;
-                filter->knockout = in->readUByte() ? true : false;
-
-                state->pushFilter(filter);
-            }
-        }
+        readFilters(in, state);
     }
 
     if (hasMasks)
     {
-        state->maskObjectIdRef = in->readU32();
+        state.maskObjectIdRef = in->readU32();
     }
-
-    return state;
 }
 
 NS_GAF_END
@@ -1,25 +1,20 @@
 #pragma once
 
-#include "DefinitionTagBase.h"
+#include "TagDefineAnimationFramesBase.h"
 
 NS_GAF_BEGIN
 
 class GAFSubobjectState;
 
-class TagDefineAnimationFrames : public DefinitionTagBase
+class TagDefineAnimationFrames : public TagDefineAnimationFramesBase
 {
 private:
-    typedef std::map<unsigned int, GAFSubobjectState*> States_t;
-    States_t m_currentStates;
-    
-    GAFSubobjectState* extractState(GAFStream* in);
+    virtual void extractState(GAFStream* in, GAFSubobjectState& state) override;
 
 public:
     
-    ~TagDefineAnimationFrames();
-    
     virtual void read(GAFStream*, GAFAsset*, GAFTimeline*) override;
 
 };
 
-NS_GAF_END
+NS_GAF_END
\ No newline at end of file
@@ -1,21 +1,17 @@
 #pragma once
 
-#include "DefinitionTagBase.h"
+#include "TagDefineAnimationFramesBase.h"
 
 NS_GAF_BEGIN
 
 class GAFSubobjectState;
 
-class TagDefineAnimationFrames2 : public DefinitionTagBase
+class TagDefineAnimationFrames2 : public TagDefineAnimationFramesBase
 {
 private:
-    GAFSubobjectState* extractState(GAFStream* in);
-    
-    typedef std::map<unsigned int, GAFSubobjectState*> States_t;
-    States_t m_currentStates;
+    virtual void extractState(GAFStream* in, GAFSubobjectState& state) override;
+
 public:
-	
-    ~TagDefineAnimationFrames2();
     
     virtual void read(GAFStream*, GAFAsset*, GAFTimeline*) override;
 
@@ -0,0 +1,236 @@
+#include "GAFPrecompiled.h"
+#include "TagDefineAnimationFramesBase.h"
+
+#include "GAFStream.h"
+#include "GAFFile.h"
+#include "GAFTimeline.h"
+#include "GAFAnimationFrame.h"
+#include "GAFSubobjectState.h"
+#include "GAFFilterData.h"
+#include "GAFFilterPool.h"
+#include "GAFArena.h"
+
+#include "PrimitiveDeserializer.h"
+
+NS_GAF_BEGIN
+
+void TagDefineAnimationFramesBase::resetStates(GAFTimeline* timeline)
+{
+    clearStates();
+
+    const AnimationObjects_t& objects = timeline->getAnimationObjects();
+    const AnimationMasks_t& masks = timeline->getAnimationMasks();
+
+    // Masks are display list objects too and have their own states
+    std::vector<uint32_t> objectIds;
+    objectIds.reserve(objects.size() + masks.size());
+    for (AnimationObjects_t::const_iterator i = objects.begin(), e = objects.end(); i != e; ++i)
+    {
+        objectIds.push_back(i->first);
+    }
+    for (AnimationMasks_t::const_iterator i = masks.begin(), e = masks.end(); i != e; ++i)
+    {
+        objectIds.push_back(i->first);
+    }
+    std::sort(objectIds.begin(), objectIds.end());
+    objectIds.erase(std::unique(objectIds.begin(), objectIds.end()), objectIds.end());
+
+    GAFStateStore& store = timeline->getStates();
+
+    m_currentStates.reserve(objectIds.size());
+    for (uint32_t objectId : objectIds)
+    {
+        m_stateSlots[objectId] = static_cast<uint32_t>(m_currentStates.size());
+        m_currentStates.push_back(store.pushEmptyState(objectId));
+    }
+}
+
+void TagDefineAnimationFramesBase::readState(GAFStream* in, GAFTimeline* timeline)
+{
+    GAFStateStore& store = timeline->getStates();
+    GAFArena* arena = in->getArena();
+
+    // Filters of a dropped state are dropped right away unless they are pooled, pooled ones may be shared already
+    const GAFArena::Marker marker = arena->getMarker();
+    const bool isRewindable = in->getFilterPool() == nullptr;
+    const unsigned int recordStart = in->getPosition();
+
+    GAFSubobjectState state;
+    extractState(in, state);
+
+    StateSlots_t::const_iterator it = m_stateSlots.find(state.objectIdRef);
+    if (it == m_stateSlots.end())
+    {
+        CCLOGERROR("Animation frame references unknown object %u", state.objectIdRef);
+        if (isRewindable)
+        {
+            arena->rewind(marker);
+        }
+        return;
+    }
+
+    // Identical records share one state
+    const unsigned char* record = in->getInput()->getDataAt(recordStart);
+    const unsigned int recordSize = in->getPosition() - recordStart;
+
+    uint32_t index = store.findInterned(record, recordSize);
+    if (index == IDNONE)
+    {
+        index = store.pushState(state);
+        store.intern(record, recordSize, index);
+    }
+    else if (isRewindable)
+    {
+        arena->rewind(marker);
+    }
+
+    m_currentStates[it->second] = index;
+    m_changedSlots.push_back(it->second);
+}
+
+static GAFFilterData* readFilter(GAFStream* in)
+{
+    GAFArena* arena = in->getArena();
+    GAFFilterType type = static_cast<GAFFilterType>(in->readU32());
+
+    if (type == GAFFilterType::Blur)
+    {
+        cocos2d::Size p;
+        PrimitiveDeserializer::deserialize(in, &p);
+        GAFBlurFilterData* blurFilter = arena->create<GAFBlurFilterData>();
+        blurFilter->blurSize = p;
+        return blurFilter;
+    }
+    else if (type == GAFFilterType::ColorMatrix)
+    {
+        GAFColorColorMatrixFilterData* colorFilter = arena->create<GAFColorColorMatrixFilterData>();
+        // Stored row by row, each row followed by its offset
+        float rows[20];
+        in->readFloats(rows, 20);
+
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            for (unsigned int j = 0; j < 4; ++j)
+            {
+                colorFilter->matrix[j * 4 + i] = rows[i * 5 + j];
+            }
+
+            colorFilter->matrix2[i] = rows[i * 5 + 4] / 255.f;
+        }
+
+        return colorFilter;
+    }
+    else if (type == GAFFilterType::Glow)
+    {
+        GAFGlowFilterData* filter = arena->create<GAFGlowFilterData>();
+        unsigned int clr = in->readU32();
+
+        PrimitiveDeserializer::translateColor(filter->color, clr);
+        filter->color.a = 1.f;
+
+        PrimitiveDeserializer::deserialize(in, &filter->blurSize);
+
+        filter->strength = in->readFloat();
+        filter->innerGlow = in->readUByte() ? true : false;
+        filter->knockout = in->readUByte() ? true : false;
+
+        return filter;
+    }
+    else if (type == GAFFilterType::DropShadow)
+    {
+        GAFDropShadowFilterData* filter = arena->create<GAFDropShadowFilterData>();
+        unsigned int clr = in->readU32();
+
+        PrimitiveDeserializer::translateColor(filter->color, clr);
+        filter->color.a = 1.f;
+
+        PrimitiveDeserializer::deserialize(in, &filter->blurSize);
+        filter->angle = in->readFloat();
+        filter->distance = in->readFloat();
+        filter->strength = in->readFloat();
+        filter->innerShadow = in->readUByte() ? true : false;
+        filter->knockout = in->readUByte() ? true : false;
+
+        return filter;
+    }
+
+    return nullptr;
+}
+
+void TagDefineAnimationFramesBase::readFilters(GAFStream* in, GAFSubobjectState& state)
+{
+    GAFArena* arena = in->getArena();
+    GAFFilterPool* pool = in->getFilterPool();
+
+    unsigned char effects = in->readUByte();
+
+    for (unsigned int e = 0; e < effects; ++e)
+    {
+        const GAFArena::Marker marker = arena->getMarker();
+        const unsigned int recordStart = in->getPosition();
+
+        GAFFilterData* filter = readFilter(in);
+        if (!filter)
+        {
+            continue;
+        }
+
+        // Filter of an identical record is used instead and the new one is dropped
+        if (pool)
+        {
+            GAFFilterData* pooled = pool->intern(in->getInput()->getDataAt(recordStart), in->getPosition() - recordStart, filter);
+            if (pooled != filter)
+            {
+                arena->rewind(marker);
+                filter = pooled;
+            }
+        }
+
+        state.pushFilter(filter);
+    }
+}
+
+GAFAnimationFrame* TagDefineAnimationFramesBase::makeFrame(GAFStream* in, GAFTimeline* timeline)
+{
+    GAFArena* arena = in->getArena();
+    const bool isKeyframe = timeline->getAnimationFrames().size() % GAF_KEYFRAME_INTERVAL == 0;
+
+    GAFAnimationFrame* frame = nullptr;
+
+    if (isKeyframe)
+    {
+        const uint32_t count = static_cast<uint32_t>(m_currentStates.size());
+        uint32_t* states = arena->allocateArray<uint32_t>(count);
+        std::copy(m_currentStates.begin(), m_currentStates.end(), states);
+
+        frame = arena->create<GAFAnimationFrame>(true, states, nullptr, count);
+    }
+    else
+    {
+        std::sort(m_changedSlots.begin(), m_changedSlots.end());
+        m_changedSlots.erase(std::unique(m_changedSlots.begin(), m_changedSlots.end()), m_changedSlots.end());
+
+        const uint32_t count = static_cast<uint32_t>(m_changedSlots.size());
+        uint32_t* states = arena->allocateArray<uint32_t>(count);
+        uint32_t* slots = arena->allocateArray<uint32_t>(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            slots[i] = m_changedSlots[i];
+            states[i] = m_currentStates[m_changedSlots[i]];
+        }
+
+        frame = arena->create<GAFAnimationFrame>(false, states, slots, count);
+    }
+
+    m_changedSlots.clear();
+    return frame;
+}
+
+void TagDefineAnimationFramesBase::clearStates()
+{
+    m_currentStates.clear();
+    m_stateSlots.clear();
+    m_changedSlots.clear();
+}
+
+NS_GAF_END
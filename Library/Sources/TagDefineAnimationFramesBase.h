@@ -0,0 +1,35 @@
+#pragma once
+
+#include <unordered_map>
+#include "DefinitionTagBase.h"
+
+NS_GAF_BEGIN
+
+class GAFAnimationFrame;
+class GAFSubobjectState;
+
+/// Keyframe and delta bookkeeping shared by readers of both frame tag versions.
+/// Readers read states of changed objects with readState and make every frame with makeFrame
+class TagDefineAnimationFramesBase : public DefinitionTagBase
+{
+protected:
+    typedef std::vector<uint32_t> States_t; // Indices in the timeline state store
+    typedef std::unordered_map<uint32_t, uint32_t> StateSlots_t; // Object id -> index in m_currentStates
+    typedef std::vector<uint32_t> ChangedSlots_t;
+
+    States_t m_currentStates;
+    StateSlots_t m_stateSlots;
+    ChangedSlots_t m_changedSlots;
+
+    void resetStates(GAFTimeline* timeline);
+    /// Reads a state record, identical records of the timeline share one stored state
+    void readState(GAFStream* in, GAFTimeline* timeline);
+    /// Reads filters of a state, filters with the same parameters are shared across the asset, see GAFFilterPool
+    void readFilters(GAFStream* in, GAFSubobjectState& state);
+    GAFAnimationFrame* makeFrame(GAFStream* in, GAFTimeline* timeline);
+    void clearStates();
+
+    virtual void extractState(GAFStream* in, GAFSubobjectState& state) = 0;
+};
+
+NS_GAF_END
@@ -12,6 +12,11 @@
 NS_GAF_BEGIN
 
 void TagDefineTimeline::read(GAFStream* in, GAFAsset* asset, GAFTimeline* timeline)
+{
+    pushTimeline(asset, readTimeline(in, asset, timeline));
+}
+
+GAFTimeline* TagDefineTimeline::readTimeline(GAFStream* in, GAFAsset* asset, GAFTimeline* timeline)
 {
     unsigned int id = in->readU32();
     unsigned int framesCount = in->readU32();
@@ -35,6 +40,13 @@ void TagDefineTimeline::read(GAFStream* in, GAFAsset* asset, GAFTimeline* timeli
 
     m_loader->loadTags(in, asset, tl);
 
+    return tl;
+}
+
+void TagDefineTimeline::pushTimeline(GAFAsset* asset, GAFTimeline* tl)
+{
+    uint32_t id = tl->getId();
+
     asset->pushTimeline(id, tl);
     if (id == 0)
     {
@@ -16,6 +16,10 @@ public:
 
     virtual void read(GAFStream*, GAFAsset*, GAFTimeline*) override;
 
+    /// Reads timeline without adding it to the asset. Does not modify the asset, so it is safe to call from worker threads
+    GAFTimeline* readTimeline(GAFStream*, GAFAsset*, GAFTimeline* parent);
+    static void  pushTimeline(GAFAsset*, GAFTimeline*);
+
 };
 
 NS_GAF_END
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "GAFPrecompiled.h"
+#include "GAFAnimationManager.h"
+#include "GAFObject.h"
+
+// Order GAFAnimationManager advances its objects in, GAFObject is the stand-in of fake/GAFObject.h
+
+USING_NS_GAF;
+
+static int s_failures = 0;
+
+#define CHECK(condition) \
+    do { if (!(condition)) { printf("FAILED: %s at %s:%d\n", #condition, __FILE__, __LINE__); ++s_failures; } } while (0)
+
+typedef std::vector<GAFObject*> Order_t;
+
+static Order_t s_order;
+
+static void update()
+{
+    s_order.clear();
+    cocos2d::Director::getInstance()->getScheduler()->update(1.f / 30);
+}
+
+static void add(GAFObject* objects, size_t count, int group = 0)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        objects[i].m_onProcessed = [](GAFObject* object) { s_order.push_back(object); };
+        GAFAnimationManager::getInstance()->addObject(&objects[i], group);
+    }
+}
+
+static void testRemoveFromMiddle()
+{
+    GAFObject objects[5];
+    add(objects, 5);
+
+    GAFAnimationManager* manager = GAFAnimationManager::getInstance();
+    manager->removeObject(&objects[1]);
+
+    update();
+    CHECK(s_order == Order_t({ &objects[0], &objects[2], &objects[3], &objects[4] }));
+    CHECK(manager->getObjectsCount() == 4);
+
+    // Indices of the objects after the removed one are updated, they are removed by them
+    manager->removeObject(&objects[3]);
+    manager->removeObject(&objects[0]);
+
+    update();
+    CHECK(s_order == Order_t({ &objects[2], &objects[4] }));
+
+    GAFAnimationManager::destroyInstance();
+}
+
+static void testRemoveDuringUpdate()
+{
+    GAFObject objects[4];
+    add(objects, 4);
+
+    GAFAnimationManager* manager = GAFAnimationManager::getInstance();
+    objects[0].m_onProcessed = [&](GAFObject* object)
+    {
+        s_order.push_back(object);
+        if (object->m_framesPlayed == 1)
+        {
+            manager->removeObject(&objects[2]);
+        }
+    };
+
+    update();
+    CHECK(s_order == Order_t({ &objects[0], &objects[1], &objects[3] }));
+
+    GAFObject added;
+    add(&added, 1);
+
+    update();
+    CHECK(s_order == Order_t({ &objects[0], &objects[1], &objects[3], &added }));
+
+    manager->removeObject(&objects[1]);
+
+    update();
+    CHECK(s_order == Order_t({ &objects[0], &objects[3], &added }));
+
+    GAFAnimationManager::destroyInstance();
+}
+
+static void testAddDuringUpdate()
+{
+    GAFObject objects[2];
+    GAFObject added;
+    add(objects, 2);
+
+    objects[0].m_onProcessed = [&](GAFObject* object)
+    {
+        s_order.push_back(object);
+        if (object->m_framesPlayed == 1)
+        {
+            add(&added, 1);
+        }
+    };
+
+    // Objects started during an update are advanced from the next one
+    update();
+    CHECK(s_order == Order_t({ &objects[0], &objects[1] }));
+
+    update();
+    CHECK(s_order == Order_t({ &objects[0], &objects[1], &added }));
+
+    GAFAnimationManager::destroyInstance();
+}
+
+static void testGroups()
+{
+    GAFObject first[2];
+    GAFObject second[2];
+    add(second, 2, 5);
+    add(first, 2, -1);
+
+    GAFAnimationManager* manager = GAFAnimationManager::getInstance();
+
+    update();
+    CHECK(s_order == Order_t({ &first[0], &first[1], &second[0], &second[1] }));
+
+    manager->pauseGroup(-1);
+    CHECK(manager->isGroupPaused(-1));
+
+    update();
+    CHECK(s_order == Order_t({ &second[0], &second[1] }));
+
+    manager->resumeGroup(-1);
+    manager->removeObject(&second[0]);
+
+    update();
+    CHECK(s_order == Order_t({ &first[0], &first[1], &second[1] }));
+
+    GAFAnimationManager::destroyInstance();
+}
+
+static void testUnscheduled()
+{
+    cocos2d::Scheduler* scheduler = cocos2d::Director::getInstance()->getScheduler();
+
+    GAFObject object;
+    add(&object, 1);
+    CHECK(scheduler->isScheduled("GAFAnimationManager", GAFAnimationManager::getInstance()));
+
+    GAFAnimationManager::getInstance()->removeObject(&object);
+    update();
+    CHECK(!scheduler->isScheduled("GAFAnimationManager", GAFAnimationManager::getInstance()));
+
+    GAFAnimationManager::destroyInstance();
+}
+
+static void setEvaluable(GAFObject* objects, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        objects[i].m_isEvaluable = true;
+    }
+}
+
+static void testEvaluation()
+{
+    GAFObject objects[6];
+    add(objects, 6);
+    setEvaluable(objects, 6);
+    objects[1].m_isEvaluable = false;
+    objects[4].m_isEvaluable = false;
+
+    GAFAnimationManager* manager = GAFAnimationManager::getInstance();
+    manager->setParallelThreshold(4);
+
+    // Every object is evaluated before the first one is played on the main thread
+    bool isEvaluatedFirst = false;
+    objects[1].m_onProcessed = [&](GAFObject* object)
+    {
+        s_order.push_back(object);
+        isEvaluatedFirst = objects[5].m_framesEvaluated == 1;
+    };
+
+    // Evaluated frames are applied in the order objects are updated, between the ones played on the main thread
+    update();
+    CHECK(s_order == Order_t({ &objects[0], &objects[1], &objects[2], &objects[3], &objects[4], &objects[5] }));
+    CHECK(isEvaluatedFirst);
+    CHECK(objects[0].m_evaluationsCount == 1 && objects[5].m_evaluationsCount == 1);
+    CHECK(objects[1].m_evaluationsCount == 0 && objects[4].m_evaluationsCount == 0);
+    CHECK(objects[3].m_framesPlayed == 1 && !objects[3].m_isEvaluated);
+
+    // Below the threshold all are played on the main thread
+    manager->setParallelThreshold(5);
+
+    update();
+    CHECK(s_order.size() == 6);
+    CHECK(objects[0].m_evaluationsCount == 1);
+
+    manager->setParallelThreshold(0);
+
+    update();
+    CHECK(objects[0].m_evaluationsCount == 1);
+    CHECK(objects[0].m_framesPlayed == 3);
+
+    GAFAnimationManager::destroyInstance();
+}
+
+static void testEvaluationChangedDuringUpdate()
+{
+    GAFObject objects[5];
+    add(objects, 5);
+    setEvaluable(objects, 5);
+    objects[0].m_isEvaluable = false;
+    objects[3].m_isEvaluable = false;
+
+    GAFAnimationManager* manager = GAFAnimationManager::getInstance();
+    manager->setParallelThreshold(2);
+
+    // Evaluated objects have been advanced, they get the frame applied even once the group is paused
+    objects[0].m_onProcessed = [&](GAFObject* object)
+    {
+        s_order.push_back(object);
+        if (object->m_framesPlayed == 1)
+        {
+            manager->pauseGroup(0);
+            manager->removeObject(&objects[2]);
+        }
+    };
+
+    update();
+    CHECK(s_order == Order_t({ &objects[0], &objects[1], &objects[4] }));
+    CHECK(objects[2].m_evaluationsCount == 1 && !objects[2].m_isEvaluated);
+    CHECK(objects[3].m_framesPlayed == 0);
+
+    update();
+    CHECK(s_order.empty());
+
+    GAFAnimationManager::destroyInstance();
+}
+
+int main()
+{
+    testRemoveFromMiddle();
+    testRemoveDuringUpdate();
+    testAddDuringUpdate();
+    testGroups();
+    testUnscheduled();
+    testEvaluation();
+    testEvaluationChangedDuringUpdate();
+
+    if (s_failures == 0)
+    {
+        printf("animation_manager_test: OK\n");
+    }
+
+    return s_failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+// Stand-in of the xxHash of cocos2d-x for the unit tests, GAFStateStore only needs a hash of state records
+
+#include <stddef.h>
+
+inline unsigned int XXH32(const void* input, size_t length, unsigned int seed)
+{
+    // FNV-1a
+    const unsigned char* bytes = static_cast<const unsigned char*>(input);
+    unsigned int hash = 2166136261u ^ seed;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+// Stand-in of GAFAsset for the GAFTimelineEvaluator tests. Timelines are pushed by the test,
+// sound events are recorded instead of being played
+
+#include "GAFCollections.h"
+#include "GAFTimeline.h"
+#include "GAFTimelineAction.h"
+
+NS_GAF_BEGIN
+
+class GAFAsset : public cocos2d::Ref
+{
+private:
+    Timelines_t             m_timelines;
+
+public:
+    std::vector<std::string> m_soundEvents;
+
+    ~GAFAsset()
+    {
+        GAF_SAFE_RELEASE_MAP(Timelines_t, m_timelines);
+    }
+
+    /// The timeline is released with the asset
+    void pushTimeline(uint32_t id, GAFTimeline* timeline) { m_timelines[id] = timeline; }
+
+    const Timelines_t& getTimelines() const { return m_timelines; }
+    Timelines_t& getTimelines() { return m_timelines; }
+
+    void soundEvent(GAFTimelineAction* action) { m_soundEvents.push_back(action->getParam(GAFTimelineAction::PI_EVENT_DATA)); }
+};
+
+NS_GAF_END
\ No newline at end of file
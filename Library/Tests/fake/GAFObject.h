@@ -0,0 +1,74 @@
+#pragma once
+
+// Stand-in of GAFObject for the GAFAnimationManager tests. Only the members the manager uses are declared,
+// processAnimations() and the evaluation record the calls instead of playing frames
+
+#include <functional>
+
+NS_GAF_BEGIN
+
+class GAFObject
+{
+public:
+    typedef std::function<void(GAFObject*)> Processed_t;
+
+    uint32_t            m_fps;
+    bool                m_skipFpsCheck;
+    bool                m_animationsSelectorScheduled;
+    int                 m_animationGroup;
+    size_t              m_animationIndex;
+    bool                m_isTickPaused;
+    bool                m_isRunning;
+    bool                m_isEvaluated;
+
+    bool                m_isEvaluable;
+    uint32_t            m_framesPlayed;
+    uint32_t            m_framesEvaluated; // Not applied yet
+    uint32_t            m_evaluationsCount;
+    Processed_t         m_onProcessed;
+
+    GAFObject()
+    : m_fps(30)
+    , m_skipFpsCheck(true)
+    , m_animationsSelectorScheduled(false)
+    , m_animationGroup(0)
+    , m_animationIndex(0)
+    , m_isTickPaused(false)
+    , m_isRunning(true)
+    , m_isEvaluated(false)
+    , m_isEvaluable(false)
+    , m_framesPlayed(0)
+    , m_framesEvaluated(0)
+    , m_evaluationsCount(0)
+    {
+    }
+
+    bool isRunning() const { return m_isRunning; }
+
+    void processAnimations(uint32_t framesCount)
+    {
+        m_framesPlayed += framesCount;
+        if (m_onProcessed)
+        {
+            m_onProcessed(this);
+        }
+    }
+
+    bool _isEvaluable(uint32_t) { return m_isEvaluable; }
+
+    // Called on worker threads
+    void _evaluate(uint32_t framesCount)
+    {
+        m_framesEvaluated += framesCount;
+        ++m_evaluationsCount;
+    }
+
+    void _applyEvaluation()
+    {
+        m_isEvaluated = false;
+        processAnimations(m_framesEvaluated);
+        m_framesEvaluated = 0;
+    }
+};
+
+NS_GAF_END
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "GAFPrecompiled.h"
+#include "GAFKTXImage.h"
+
+// KTX container parsing, no GL is involved
+
+USING_NS_GAF;
+
+static int s_failures = 0;
+
+#define CHECK(condition) \
+    do { if (!(condition)) { printf("FAILED: %s at %s:%d\n", #condition, __FILE__, __LINE__); ++s_failures; } } while (0)
+
+static const uint32_t GL_COMPRESSED_RGB8_ETC2 = 0x9274;
+static const uint32_t GL_RGB = 0x1907;
+static const uint32_t GL_UNSIGNED_BYTE = 0x1401;
+
+// Container of an 8x8 ETC2 image with two mipmap levels and 8 bytes of key/value data
+struct KTXBuilder
+{
+    uint32_t glType;
+    uint32_t glFormat;
+    uint32_t pixelDepth;
+    uint32_t arrayElements;
+    uint32_t faces;
+    uint32_t mipmapLevels;
+    uint32_t keyValueBytes;
+    bool     isSwapped;
+
+    KTXBuilder()
+    : glType(0), glFormat(0), pixelDepth(0), arrayElements(0), faces(1), mipmapLevels(2), keyValueBytes(8), isSwapped(false)
+    {
+    }
+
+    void pushU32(std::vector<unsigned char>& out, uint32_t value) const
+    {
+        if (isSwapped)
+        {
+            value = (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+        }
+
+        unsigned char bytes[4];
+        memcpy(bytes, &value, sizeof(bytes));
+        out.insert(out.end(), bytes, bytes + 4);
+    }
+
+    std::vector<unsigned char> build() const
+    {
+        static const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+        std::vector<unsigned char> out(identifier, identifier + sizeof(identifier));
+        pushU32(out, 0x04030201);
+        pushU32(out, glType);
+        pushU32(out, 1);
+        pushU32(out, glFormat);
+        pushU32(out, GL_COMPRESSED_RGB8_ETC2);
+        pushU32(out, GL_RGB);
+        pushU32(out, 8);
+        pushU32(out, 8);
+        pushU32(out, pixelDepth);
+        pushU32(out, arrayElements);
+        pushU32(out, faces);
+        pushU32(out, mipmapLevels);
+        pushU32(out, keyValueBytes);
+
+        out.insert(out.end(), 8, 0xEE); // Key/value data
+
+        // 8x8 level is 4 ETC2 blocks, 4x4 one is a single block
+        pushU32(out, 32);
+        out.insert(out.end(), 32, 0x11);
+        pushU32(out, 8);
+        out.insert(out.end(), 8, 0x22);
+
+        return out;
+    }
+};
+
+static bool parse(GAFKTXImage& image, const std::vector<unsigned char>& bytes)
+{
+    cocos2d::Data data;
+    data.copy(bytes.data(), static_cast<ssize_t>(bytes.size()));
+    return image.initWithData(data);
+}
+
+static void checkValidImage(const GAFKTXImage& image)
+{
+    CHECK(image.getInternalFormat() == GL_COMPRESSED_RGB8_ETC2);
+    CHECK(image.getWidth() == 8);
+    CHECK(image.getHeight() == 8);
+    CHECK(image.getLevels().size() == 2);
+    CHECK(image.getImageSize() == 40);
+
+    if (image.getLevels().size() == 2)
+    {
+        const GAFKTXImage::Level& first = image.getLevels()[0];
+        const GAFKTXImage::Level& second = image.getLevels()[1];
+
+        // 64 bytes of header, 8 of key/value data and the size of the level
+        CHECK(first.offset == 76);
+        CHECK(first.size == 32);
+        CHECK(second.offset == 112);
+        CHECK(second.size == 8);
+        CHECK(image.getData()[first.offset] == 0x11);
+        CHECK(image.getData()[second.offset] == 0x22);
+    }
+}
+
+static void testValidFile()
+{
+    GAFKTXImage image;
+    CHECK(parse(image, KTXBuilder().build()));
+    checkValidImage(image);
+}
+
+static void testSwappedEndianness()
+{
+    KTXBuilder builder;
+    builder.isSwapped = true;
+
+    GAFKTXImage image;
+    CHECK(parse(image, builder.build()));
+    checkValidImage(image);
+}
+
+static void testTruncatedLevel()
+{
+    std::vector<unsigned char> bytes = KTXBuilder().build();
+
+    // Every cut inside the levels leaves one of them short
+    for (size_t size = 76; size < bytes.size(); ++size)
+    {
+        GAFKTXImage image;
+        CHECK(!parse(image, std::vector<unsigned char>(bytes.begin(), bytes.begin() + size)));
+        CHECK(image.getLevels().empty());
+    }
+
+    GAFKTXImage image;
+    CHECK(!parse(image, std::vector<unsigned char>(bytes.begin(), bytes.begin() + 40)));
+}
+
+static void testOversizedKeyValueData()
+{
+    KTXBuilder builder;
+    builder.keyValueBytes = 0xFFFFFFF0;
+
+    GAFKTXImage image;
+    CHECK(!parse(image, builder.build()));
+
+    // Key/value data ends past the end of the file
+    builder.keyValueBytes = 61;
+    CHECK(!parse(image, builder.build()));
+}
+
+static void testNonCompressedFile()
+{
+    KTXBuilder builder;
+    builder.glType = GL_UNSIGNED_BYTE;
+    builder.glFormat = GL_RGB;
+
+    GAFKTXImage image;
+    CHECK(!parse(image, builder.build()));
+}
+
+static void testCubemapRejected()
+{
+    KTXBuilder builder;
+    builder.faces = 6;
+
+    GAFKTXImage image;
+    CHECK(!parse(image, builder.build()));
+
+    builder.faces = 1;
+    builder.arrayElements = 2;
+    CHECK(!parse(image, builder.build()));
+}
+
+static void testWrongIdentifier()
+{
+    std::vector<unsigned char> bytes = KTXBuilder().build();
+    bytes[1] = 'X';
+
+    GAFKTXImage image;
+    CHECK(!parse(image, bytes));
+    CHECK(!image.initWithData(cocos2d::Data()));
+}
+
+int main()
+{
+    testValidFile();
+    testSwappedEndianness();
+    testTruncatedLevel();
+    testOversizedKeyValueData();
+    testNonCompressedFile();
+    testCubemapRejected();
+    testWrongIdentifier();
+
+    if (s_failures == 0)
+    {
+        printf("ktx_image_test: OK\n");
+    }
+
+    return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#include "GAFPrecompiled.h"
+#include "GAFAlphaPremultiplier.h"
+
+// Vector premultiplication is compared with the scalar one for every color and alpha pair
+// and for buffers that do not end on a whole vector
+
+USING_NS_GAF;
+
+static int s_failures = 0;
+
+static void check(bool condition, const char* message, size_t index)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s at %zu\n", message, index);
+        ++s_failures;
+    }
+}
+
+static void testAllPairs()
+{
+    // Every channel of a pixel is given its own color so that mixed up lanes are caught
+    std::vector<unsigned char> pixels;
+    pixels.reserve(256 * 256 * 4);
+    for (unsigned int a = 0; a < 256; ++a)
+    {
+        for (unsigned int c = 0; c < 256; ++c)
+        {
+            pixels.push_back(static_cast<unsigned char>(c));
+            pixels.push_back(static_cast<unsigned char>(255 - c));
+            pixels.push_back(static_cast<unsigned char>(c ^ 0x5A));
+            pixels.push_back(static_cast<unsigned char>(a));
+        }
+    }
+
+    std::vector<unsigned char> expected = pixels;
+    GAFAlphaPremultiplier::premultiplyScalar(expected.data(), expected.size() / 4);
+    GAFAlphaPremultiplier::premultiply(pixels.data(), pixels.size() / 4);
+
+    for (size_t i = 0; i < pixels.size(); ++i)
+    {
+        check(pixels[i] == expected[i], "vector and scalar results differ", i);
+    }
+
+    // The scalar path matches the formula of CC_RGB_PREMULTIPLY_ALPHA
+    for (size_t i = 0; i < expected.size(); i += 4)
+    {
+        const unsigned int a = expected[i + 3];
+        check(expected[i] == ((i / 4) % 256) * (a + 1) >> 8, "scalar result is wrong", i);
+    }
+}
+
+static void testTails()
+{
+    for (size_t count = 0; count <= 19; ++count)
+    {
+        // Guard pixels after the buffer must stay untouched
+        std::vector<unsigned char> pixels((count + 2) * 4);
+        for (size_t i = 0; i < pixels.size(); ++i)
+        {
+            pixels[i] = static_cast<unsigned char>(i * 37 + 11);
+        }
+
+        std::vector<unsigned char> expected = pixels;
+        GAFAlphaPremultiplier::premultiplyScalar(expected.data(), count);
+        GAFAlphaPremultiplier::premultiply(pixels.data(), count);
+
+        for (size_t i = 0; i < pixels.size(); ++i)
+        {
+            check(pixels[i] == expected[i], "tail differs", count * 1000 + i);
+        }
+    }
+}
+
+int main()
+{
+    testAllPairs();
+    testTails();
+
+    if (s_failures == 0)
+    {
+        printf("premultiply_test: OK\n");
+    }
+
+    return s_failures == 0 ? 0 : 1;
+}
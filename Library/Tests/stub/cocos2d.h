@@ -0,0 +1,194 @@
+#pragma once
+
+// Minimal stand-in of cocos2d.h for the unit tests. Only what the tested library sources use is declared here
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/types.h>
+#include <assert.h>
+#include <functional>
+#include <limits>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#define COCOS2D_VERSION 0x00030000
+
+#define CCLOG(...) do { } while (0)
+#define CCLOGERROR(...) do { } while (0)
+
+#define CCAssert(cond, msg) assert(cond)
+#define CCASSERT(cond, msg) assert(cond)
+
+#define CC_SAFE_RETAIN(p) do { if (p) { (p)->retain(); } } while (0)
+#define CC_SAFE_RELEASE(p) do { if (p) { (p)->release(); } } while (0)
+#define CC_SAFE_DELETE(p) do { delete (p); (p) = nullptr; } while (0)
+
+namespace cocos2d
+{
+    class Ref
+    {
+    private:
+        unsigned int    m_referenceCount;
+
+    public:
+        Ref() : m_referenceCount(1) {}
+        virtual ~Ref() {}
+
+        void retain() { ++m_referenceCount; }
+        void release() { if (--m_referenceCount == 0) { delete this; } }
+        unsigned int getReferenceCount() const { return m_referenceCount; }
+    };
+
+    struct Vec2
+    {
+        float x;
+        float y;
+
+        Vec2() : x(0.f), y(0.f) {}
+        Vec2(float xx, float yy) : x(xx), y(yy) {}
+    };
+
+    typedef Vec2 Point;
+    typedef Vec2 Vect;
+
+    struct Size
+    {
+        float width;
+        float height;
+
+        Size() : width(0.f), height(0.f) {}
+        Size(float w, float h) : width(w), height(h) {}
+    };
+
+    struct Rect
+    {
+        Vec2    origin;
+        Size    size;
+
+        Rect() {}
+        Rect(float x, float y, float w, float h) : origin(x, y), size(w, h) {}
+
+        float getMinX() const { return origin.x; }
+        float getMinY() const { return origin.y; }
+    };
+
+    struct Color4B
+    {
+        uint8_t r, g, b, a;
+    };
+
+    struct Color4F
+    {
+        float r, g, b, a;
+    };
+
+    enum class TextHAlignment
+    {
+        LEFT,
+        CENTER,
+        RIGHT
+    };
+
+    struct AffineTransform
+    {
+        float a, b, c, d;
+        float tx, ty;
+    };
+
+    inline AffineTransform AffineTransformMake(float a, float b, float c, float d, float tx, float ty)
+    {
+        AffineTransform t = { a, b, c, d, tx, ty };
+        return t;
+    }
+
+    inline AffineTransform AffineTransformTranslate(const AffineTransform& t, float tx, float ty)
+    {
+        return AffineTransformMake(t.a, t.b, t.c, t.d, t.tx + t.a * tx + t.c * ty, t.ty + t.b * tx + t.d * ty);
+    }
+
+    inline AffineTransform AffineTransformScale(const AffineTransform& t, float sx, float sy)
+    {
+        return AffineTransformMake(t.a * sx, t.b * sx, t.c * sy, t.d * sy, t.tx, t.ty);
+    }
+
+    inline AffineTransform AffineTransformConcat(const AffineTransform& t1, const AffineTransform& t2)
+    {
+        return AffineTransformMake(t1.a * t2.a + t1.b * t2.c, t1.a * t2.b + t1.b * t2.d,
+                                   t1.c * t2.a + t1.d * t2.c, t1.c * t2.b + t1.d * t2.d,
+                                   t1.tx * t2.a + t1.ty * t2.c + t2.tx, t1.tx * t2.b + t1.ty * t2.d + t2.ty);
+    }
+
+    // Records names of the dispatched events
+    class EventDispatcher
+    {
+    public:
+        std::vector<std::string>    m_dispatched;
+
+        void dispatchCustomEvent(const std::string& eventName, void* = nullptr) { m_dispatched.push_back(eventName); }
+    };
+
+    // Byte buffer with the copy semantics of cocos2d::Data
+    class Data
+    {
+    private:
+        std::vector<unsigned char>  m_bytes;
+        bool                        m_isNull;
+
+    public:
+        Data() : m_isNull(true) {}
+
+        unsigned char*  getBytes() const { return m_isNull ? nullptr : const_cast<unsigned char*>(m_bytes.data()); }
+        ssize_t         getSize() const { return static_cast<ssize_t>(m_bytes.size()); }
+        bool            isNull() const { return m_isNull; }
+
+        void            copy(const unsigned char* bytes, ssize_t size) { m_bytes.assign(bytes, bytes + size); m_isNull = false; }
+        void            clear() { m_bytes.clear(); m_isNull = true; }
+    };
+
+    class FileUtils
+    {
+    public:
+        static FileUtils* getInstance() { static FileUtils instance; return &instance; }
+
+        Data getDataFromFile(const std::string&) { return Data(); }
+    };
+
+    // Keeps the scheduled callbacks, update() calls them the same as the scheduler of a running application
+    class Scheduler
+    {
+    private:
+        typedef std::function<void(float)> Callback_t;
+
+        std::map<std::string, Callback_t>   m_callbacks;
+
+    public:
+        void schedule(const Callback_t& callback, void*, float, bool, const std::string& key) { m_callbacks[key] = callback; }
+        void unschedule(const std::string& key, void*) { m_callbacks.erase(key); }
+        bool isScheduled(const std::string& key, void*) const { return m_callbacks.count(key) != 0; }
+
+        void update(float dt)
+        {
+            std::map<std::string, Callback_t> callbacks = m_callbacks;
+            for (std::map<std::string, Callback_t>::iterator i = callbacks.begin(); i != callbacks.end(); ++i)
+            {
+                i->second(dt);
+            }
+        }
+    };
+
+    class Director
+    {
+    private:
+        Scheduler           m_scheduler;
+        EventDispatcher     m_eventDispatcher;
+
+    public:
+        static Director* getInstance() { static Director instance; return &instance; }
+
+        Scheduler* getScheduler() { return &m_scheduler; }
+        EventDispatcher* getEventDispatcher() { return &m_eventDispatcher; }
+    };
+}
@@ -0,0 +1,459 @@
+#include "GAFPrecompiled.h"
+#include "GAFTimelineEvaluator.h"
+#include "GAFAsset.h"
+#include "GAFTimeline.h"
+#include "GAFTextureAtlas.h"
+#include "GAFTextureAtlasElement.h"
+#include "GAFSoundInfo.h"
+
+// Flat output of GAFTimelineEvaluator for small hand made timelines, GAFAsset is the stand-in of fake/GAFAsset.h
+
+USING_NS_GAF;
+
+static int s_failures = 0;
+
+#define CHECK(condition) \
+    do { if (!(condition)) { printf("FAILED: %s at %s:%d\n", #condition, __FILE__, __LINE__); ++s_failures; } } while (0)
+
+static bool near(float a, float b)
+{
+    return fabs(a - b) < 1e-4f;
+}
+
+struct State
+{
+    uint32_t                    objectId;
+    int                         zIndex;
+    cocos2d::AffineTransform    transform;  // In flash coordinates, as GAF files keep it
+    float                       colorMults[4];
+    float                       colorOffsets[4];
+};
+
+typedef std::vector<State> FrameStates_t;
+
+static cocos2d::AffineTransform translate(float x, float y)
+{
+    return cocos2d::AffineTransformMake(1.f, 0.f, 0.f, 1.f, x, y);
+}
+
+static cocos2d::AffineTransform scale(float s)
+{
+    return cocos2d::AffineTransformMake(s, 0.f, 0.f, s, 0.f, 0.f);
+}
+
+static State state(uint32_t objectId, int zIndex, const cocos2d::AffineTransform& transform, float alpha = 1.f)
+{
+    State s = { objectId, zIndex, transform, { 1.f, 1.f, 1.f, alpha }, { 0.f, 0.f, 0.f, 0.f } };
+    return s;
+}
+
+// Frames and their state arrays are owned by the asset arena in the player, here by the test
+static std::vector<GAFAnimationFrame*> s_frames;
+static std::vector<std::vector<uint32_t> > s_frameStates;
+
+static void clearFrames()
+{
+    for (GAFAnimationFrame* frame : s_frames)
+    {
+        delete frame;
+    }
+    s_frames.clear();
+    s_frameStates.clear();
+}
+
+// Every frame is a keyframe with the states of all objects in the order of their ids. Textures use
+// element 1 of the atlas that is 10 points high and has its pivot at (2, 3)
+static GAFTimeline* makeTimeline(GAFAsset* asset, uint32_t id, const std::vector<FrameStates_t>& frames)
+{
+    cocos2d::Point pivot;
+    GAFTimeline* timeline = new GAFTimeline(nullptr, id, cocos2d::Rect(0.f, 0.f, 100.f, 100.f), pivot, static_cast<uint32_t>(frames.size()));
+
+    GAFTextureAtlasElement* element = new GAFTextureAtlasElement();
+    element->setScale(1.f);
+    element->bounds = cocos2d::Rect(0.f, 0.f, 10.f, 10.f);
+    element->pivotPoint = cocos2d::Vec2(2.f, 3.f);
+
+    GAFTextureAtlas* atlas = new GAFTextureAtlas();
+    atlas->setScale(1.f);
+    atlas->pushElement(1, element);
+    timeline->pushTextureAtlas(atlas);
+
+    std::vector<uint32_t> objectIds;
+    std::vector<uint32_t> maskObjectIds;
+    std::vector<int> zIndices;
+    std::vector<cocos2d::AffineTransform> transforms;
+    std::vector<float> colorMults;
+    std::vector<float> colorOffsets;
+
+    for (const FrameStates_t& states : frames)
+    {
+        for (const State& s : states)
+        {
+            objectIds.push_back(s.objectId);
+            maskObjectIds.push_back(IDNONE);
+            zIndices.push_back(s.zIndex);
+            transforms.push_back(s.transform);
+            colorMults.insert(colorMults.end(), s.colorMults, s.colorMults + 4);
+            colorOffsets.insert(colorOffsets.end(), s.colorOffsets, s.colorOffsets + 4);
+        }
+    }
+
+    const std::vector<uint32_t> filterLists(objectIds.size(), 0);
+    timeline->getStates().assign(objectIds.size(), objectIds.data(), maskObjectIds.data(), zIndices.data(),
+                                 transforms.data(), colorMults.data(), colorOffsets.data(), filterLists.data());
+
+    uint32_t first = 0;
+    for (const FrameStates_t& states : frames)
+    {
+        std::vector<uint32_t> indices;
+        for (uint32_t i = 0; i < states.size(); ++i)
+        {
+            indices.push_back(first + i);
+        }
+        first += static_cast<uint32_t>(states.size());
+
+        s_frameStates.push_back(indices);
+        s_frames.push_back(new GAFAnimationFrame(true, s_frameStates.back().data(), nullptr, static_cast<uint32_t>(indices.size())));
+        timeline->pushAnimationFrame(s_frames.back());
+    }
+    timeline->endLoading();
+    timeline->loadImages(1.f);
+
+    asset->pushTimeline(id, timeline);
+    return timeline;
+}
+
+static void pushEvent(GAFTimeline* timeline, uint32_t frame, const std::string& type, const std::string& data = std::string())
+{
+    ActionParams_t params(1, type);
+    if (!data.empty())
+    {
+        params.resize(GAFTimelineAction::PI_EVENT_DATA);
+        params.push_back(data);
+    }
+
+    GAFTimelineAction action;
+    action.setAction(GAFActionType::DispatchEvent, params, "");
+    const_cast<GAFAnimationFrame*>(timeline->getAnimationFrames()[frame])->pushTimelineAction(action);
+}
+
+static bool isTransform(const cocos2d::AffineTransform& t, float a, float d, float tx, float ty)
+{
+    return near(t.a, a) && near(t.b, 0.f) && near(t.c, 0.f) && near(t.d, d) && near(t.tx, tx) && near(t.ty, ty);
+}
+
+static void testFlatOutput()
+{
+    GAFAsset* asset = new GAFAsset();
+
+    // Root: textures 0 and 2, the nested timeline 1 scaled twice, the nested timeline 3 in the reset state
+    State nestedState = state(1, 1, scale(2.f), 0.5f);
+    nestedState.colorOffsets[0] = 0.1f;
+
+    FrameStates_t root;
+    root.push_back(state(0, 3, translate(10.f, 20.f)));
+    root.push_back(nestedState);
+    root.push_back(state(2, 0, translate(0.f, 0.f), 0.f));
+    root.push_back(state(3, 2, translate(0.f, 0.f), -1.f));
+
+    State textureState = state(0, 7, translate(1.f, 1.f));
+    textureState.colorMults[0] = 0.5f;
+    textureState.colorOffsets[1] = 0.2f;
+
+    GAFTimeline* rootTimeline = makeTimeline(asset, 0, std::vector<FrameStates_t>(1, root));
+    GAFTimeline* nested = makeTimeline(asset, 1, std::vector<FrameStates_t>(1, FrameStates_t(1, textureState)));
+    makeTimeline(asset, 2, std::vector<FrameStates_t>(1, FrameStates_t(1, state(0, 0, translate(0.f, 0.f)))));
+
+    rootTimeline->pushAnimationObject(0, 1, GAFCharacterType::Texture);
+    rootTimeline->pushAnimationObject(1, 1, GAFCharacterType::Timeline);
+    rootTimeline->pushAnimationObject(2, 1, GAFCharacterType::Texture);
+    rootTimeline->pushAnimationObject(3, 2, GAFCharacterType::Timeline);
+    nested->pushAnimationObject(0, 1, GAFCharacterType::Texture);
+    asset->getTimelines()[2]->pushAnimationObject(0, 1, GAFCharacterType::Texture);
+
+    {
+        GAFTimelineEvaluator evaluator(asset, rootTimeline);
+        CHECK(evaluator.getInstancesCount() == 3);
+
+        GAFTimelineEvaluator::Objects_t out;
+        evaluator.step(translate(100.f, 0.f), out);
+
+        // Hidden texture and the nested timeline in the reset state are not evaluated, z orders the rest
+        CHECK(out.size() == 2);
+        if (out.size() == 2)
+        {
+            // Flash y goes down, the texture is placed by the pivot of its element
+            const GAFEvaluatedObject& inNested = out[0];
+            CHECK(inNested.timeline == nested);
+            CHECK(inNested.objectId == 0);
+            CHECK(inNested.type == GAFCharacterType::Texture);
+            CHECK(inNested.element != nullptr);
+            CHECK(inNested.zIndex == 7);
+            CHECK(isTransform(inNested.transform, 2.f, 2.f, 98.f, -16.f));
+            CHECK(near(inNested.colorMults[0], 0.5f) && near(inNested.colorMults[1], 1.f) && near(inNested.colorMults[3], 0.5f));
+            CHECK(near(inNested.colorOffsets[0], 0.1f) && near(inNested.colorOffsets[1], 0.2f));
+
+            const GAFEvaluatedObject& inRoot = out[1];
+            CHECK(inRoot.timeline == rootTimeline);
+            CHECK(inRoot.instance == 0);
+            CHECK(inRoot.objectId == 0);
+            CHECK(inRoot.zIndex == 3);
+            CHECK(!inRoot.isMask);
+            CHECK(inRoot.maskObjectId == IDNONE);
+            CHECK(isTransform(inRoot.transform, 1.f, 1.f, 108.f, -27.f));
+            CHECK(near(inRoot.colorMults[3], 1.f) && near(inRoot.colorOffsets[0], 0.f));
+        }
+    }
+
+    asset->release();
+    clearFrames();
+}
+
+static void testNestedTimelinesOrder()
+{
+    GAFAsset* asset = new GAFAsset();
+
+    // Timeline 1 is above timeline 2, it is stepped first by its object id
+    FrameStates_t root;
+    root.push_back(state(0, 5, translate(0.f, 0.f)));
+    root.push_back(state(1, 1, translate(50.f, 0.f)));
+
+    GAFTimeline* rootTimeline = makeTimeline(asset, 0, std::vector<FrameStates_t>(1, root));
+    GAFTimeline* upper = makeTimeline(asset, 1, std::vector<FrameStates_t>(1, FrameStates_t(1, state(0, 0, translate(0.f, 0.f)))));
+    GAFTimeline* lower = makeTimeline(asset, 2, std::vector<FrameStates_t>(1, FrameStates_t(1, state(0, 0, translate(0.f, 0.f)))));
+
+    rootTimeline->pushAnimationObject(0, 1, GAFCharacterType::Timeline);
+    rootTimeline->pushAnimationObject(1, 2, GAFCharacterType::Timeline);
+    upper->pushAnimationObject(0, 1, GAFCharacterType::Texture);
+    lower->pushAnimationObject(0, 1, GAFCharacterType::Texture);
+
+    pushEvent(rootTimeline, 0, "root");
+    pushEvent(upper, 0, "upper");
+    pushEvent(lower, 0, "lower");
+
+    std::vector<std::string>& dispatched = cocos2d::Director::getInstance()->getEventDispatcher()->m_dispatched;
+    dispatched.clear();
+
+    {
+        GAFTimelineEvaluator evaluator(asset, rootTimeline);
+
+        GAFTimelineEvaluator::Objects_t out;
+        evaluator.step(translate(0.f, 0.f), out);
+
+        // Nested timelines perform their actions in the order they are stepped, then the one they are in does
+        CHECK(dispatched == std::vector<std::string>({ "upper", "lower", "root" }));
+
+        CHECK(out.size() == 2);
+        if (out.size() == 2)
+        {
+            CHECK(out[0].timeline == lower);
+            CHECK(out[1].timeline == upper);
+            CHECK(near(out[0].transform.tx, 48.f));
+            CHECK(near(out[1].transform.tx, -2.f));
+        }
+    }
+
+    asset->release();
+    clearFrames();
+}
+
+static void testPlayback()
+{
+    GAFAsset* asset = new GAFAsset();
+
+    // The texture is hidden in the second frame
+    std::vector<FrameStates_t> frames;
+    frames.push_back(FrameStates_t(1, state(0, 0, translate(0.f, 0.f))));
+    frames.push_back(FrameStates_t(1, state(0, 0, translate(0.f, 0.f), 0.f)));
+
+    GAFTimeline* timeline = makeTimeline(asset, 0, frames);
+    timeline->pushAnimationObject(0, 1, GAFCharacterType::Texture);
+
+    {
+        GAFTimelineEvaluator evaluator(asset, timeline);
+        GAFTimelineEvaluator::Objects_t out;
+
+        evaluator.start();
+        CHECK(evaluator.isRunning());
+
+        evaluator.step(translate(0.f, 0.f), out);
+        CHECK(evaluator.getCurrentFrameIndex() == 0);
+        CHECK(out.size() == 1);
+
+        // Not looped, it stops at the last frame
+        evaluator.step(translate(0.f, 0.f), out);
+        CHECK(evaluator.getCurrentFrameIndex() == 1);
+        CHECK(out.empty());
+        CHECK(!evaluator.isRunning());
+
+        evaluator.step(translate(0.f, 0.f), out);
+        CHECK(evaluator.getCurrentFrameIndex() == 1);
+        CHECK(out.empty());
+    }
+
+    asset->release();
+    clearFrames();
+}
+
+static void testBoundCursors()
+{
+    GAFAsset* asset = new GAFAsset();
+
+    std::vector<FrameStates_t> frames(2, FrameStates_t(1, state(0, 0, translate(0.f, 0.f))));
+    GAFTimeline* rootTimeline = makeTimeline(asset, 0, frames);
+    GAFTimeline* nested = makeTimeline(asset, 1, frames);
+
+    rootTimeline->pushAnimationObject(0, 1, GAFCharacterType::Timeline);
+    nested->pushAnimationObject(0, 1, GAFCharacterType::Texture);
+
+    {
+        GAFTimelineEvaluator evaluator(asset, rootTimeline);
+        GAFTimelineEvaluator::Objects_t out;
+
+        // Cursors of GAFObject nodes are kept by the nodes, the nested one is already running there
+        GAFTimelineCursor rootCursor;
+        GAFTimelineCursor nestedCursor;
+        rootCursor.sequenceEnd = 2;
+        nestedCursor.sequenceEnd = 2;
+        nestedCursor.isRunning = true;
+        nestedCursor.isLooped = true;
+
+        evaluator.setCursor(0, &rootCursor);
+        evaluator.setCursor(evaluator.getChildInstance(0, 0), &nestedCursor);
+
+        evaluator.start();
+        CHECK(rootCursor.isRunning);
+
+        evaluator.step(translate(0.f, 0.f), out);
+        CHECK(rootCursor.showingFrame == 0 && rootCursor.currentFrame == 1);
+        CHECK(nestedCursor.showingFrame == 0 && nestedCursor.currentFrame == 1);
+        CHECK(evaluator.getCurrentFrameIndex() == 0);
+
+        evaluator.step(translate(0.f, 0.f), out);
+        CHECK(!rootCursor.isRunning);
+        CHECK(nestedCursor.showingFrame == 1 && nestedCursor.currentFrame == 0);
+
+        // The own cursor was never started
+        evaluator.setCursor(0, nullptr);
+        CHECK(!evaluator.isRunning());
+        CHECK(evaluator.getCurrentFrameIndex() == 0);
+    }
+
+    asset->release();
+    clearFrames();
+}
+
+static void testDeferredEvents()
+{
+    GAFAsset* asset = new GAFAsset();
+
+    GAFTimeline* timeline = makeTimeline(asset, 0, std::vector<FrameStates_t>(1, FrameStates_t(1, state(0, 0, translate(0.f, 0.f)))));
+    timeline->pushAnimationObject(0, 1, GAFCharacterType::Texture);
+
+    pushEvent(timeline, 0, "first");
+    pushEvent(timeline, 0, GAFSoundInfo::SoundEvent, "sound");
+    pushEvent(timeline, 0, "second");
+
+    cocos2d::EventDispatcher* dispatcher = cocos2d::Director::getInstance()->getEventDispatcher();
+    dispatcher->m_dispatched.clear();
+
+    {
+        GAFTimelineEvaluator evaluator(asset, timeline);
+        evaluator.setEventsDeferred(true);
+
+        GAFTimelineEvaluator::Objects_t out;
+        evaluator.step(translate(0.f, 0.f), out);
+        evaluator.step(translate(0.f, 0.f), out);
+
+        CHECK(dispatcher->m_dispatched.empty());
+        CHECK(asset->m_soundEvents.empty());
+
+        evaluator.dispatchDeferredEvents(dispatcher);
+        CHECK(dispatcher->m_dispatched == std::vector<std::string>({ "first", "second", "first", "second" }));
+        CHECK(asset->m_soundEvents == std::vector<std::string>({ "sound", "sound" }));
+
+        // Kept events are dispatched once
+        evaluator.dispatchDeferredEvents(dispatcher);
+        CHECK(dispatcher->m_dispatched.size() == 4);
+    }
+
+    asset->release();
+    clearFrames();
+}
+
+static void testTimelinesIncluded()
+{
+    GAFAsset* asset = new GAFAsset();
+
+    FrameStates_t root;
+    root.push_back(state(0, 3, translate(0.f, 0.f)));
+    root.push_back(state(1, 1, translate(5.f, 0.f), 0.5f));
+
+    GAFTimeline* rootTimeline = makeTimeline(asset, 0, std::vector<FrameStates_t>(1, root));
+    GAFTimeline* nested = makeTimeline(asset, 1, std::vector<FrameStates_t>(1, FrameStates_t(1, state(0, 0, translate(0.f, 0.f)))));
+
+    rootTimeline->pushAnimationObject(0, 1, GAFCharacterType::Texture);
+    rootTimeline->pushAnimationObject(1, 1, GAFCharacterType::Timeline);
+    nested->pushAnimationObject(0, 1, GAFCharacterType::Texture);
+
+    {
+        GAFTimelineEvaluator evaluator(asset, rootTimeline);
+        evaluator.setTimelinesIncluded(true);
+
+        const uint32_t child = evaluator.getChildInstance(0, 1);
+        CHECK(child == 1);
+        CHECK(evaluator.getChildInstance(0, 0) == IDNONE);
+
+        uint32_t frameIndex = 0;
+        CHECK(evaluator.getFrameStates(child, frameIndex).empty());
+        CHECK(frameIndex == IDNONE);
+
+        GAFTimelineEvaluator::Objects_t out;
+        evaluator.step(translate(0.f, 0.f), out);
+
+        // The nested timeline comes before its objects and is drawn by its own z index
+        CHECK(out.size() == 3);
+        if (out.size() == 3)
+        {
+            CHECK(out[0].type == GAFCharacterType::Timeline);
+            CHECK(out[0].instance == 0 && out[0].objectId == 1 && out[0].reference == 1);
+            CHECK(out[0].slot == 1 && out[0].state == 1);
+            CHECK(out[0].element == nullptr);
+            CHECK(near(out[0].transform.tx, 5.f) && near(out[0].colorMults[3], 0.5f));
+
+            CHECK(out[1].instance == child && out[1].slot == 0 && out[1].state == 0);
+            CHECK(near(out[1].colorMults[3], 0.5f));
+
+            CHECK(out[2].instance == 0 && out[2].objectId == 0 && out[2].slot == 0);
+        }
+
+        const GAFAnimationFrame::SubobjectStates_t& states = evaluator.getFrameStates(child, frameIndex);
+        CHECK(frameIndex == 0);
+        CHECK(states.size() == 1);
+
+        // Without them only the objects are output
+        evaluator.setTimelinesIncluded(false);
+        evaluator.step(translate(0.f, 0.f), out);
+        CHECK(out.size() == 2);
+    }
+
+    asset->release();
+    clearFrames();
+}
+
+int main()
+{
+    testFlatOutput();
+    testNestedTimelinesOrder();
+    testPlayback();
+    testBoundCursors();
+    testDeferredEvents();
+    testTimelinesIncluded();
+
+    if (s_failures == 0)
+    {
+        printf("timeline_evaluator_test: OK\n");
+    }
+
+    return s_failures == 0 ? 0 : 1;
+}
\ No newline at end of file